@@ -22,38 +22,28 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-CONFIG += c++11
+CONFIG += c++17
+
+include(engine.pri)
 
 SOURCES += \
-    src/board.cpp \
-    src/game.cpp \
-    src/game_rules.cpp \
-    src/move_info.cpp \
-    src/piece.cpp \
-    src/pressure_factory.cpp \
-    src/square.cpp \
-    src/string_tok.cpp \
-    src/engine.cpp \
-    src/square_widget.cpp \
+    src/piece_cache.cpp \
+    src/board_widget.cpp \
+    src/move_history_model.cpp \
+    src/engine_worker.cpp \
+    src/analyser.cpp \
     main.cpp \
     chess.cpp \
     src/victory_screen.cpp
 
 HEADERS += \
-    include/chess/engine/board.hpp \
-    include/chess/engine/game.hpp \
-    include/chess/engine/game_rules.hpp \
-    include/chess/engine/move_info.hpp \
-    include/chess/engine/move_type.hpp \
-    include/chess/engine/piece.hpp \
-    include/chess/engine/pressure_factory.hpp \
-    include/chess/engine/square.hpp \
-    include/chess/engine/string_tok.hpp \
-    include/chess/engine/engine.hpp \
-    include/chess/square_widget.hpp \
+    include/chess/piece_cache.hpp \
+    include/chess/board_widget.hpp \
+    include/chess/move_history_model.hpp \
+    include/chess/engine_worker.hpp \
+    include/chess/analyser.hpp \
     chess.hpp \
-    include/chess/victory_screen.hpp \
-    include/chess/engine/game_state.hpp
+    include/chess/victory_screen.hpp
 
 FORMS += \
         chess.ui
@@ -1,13 +1,15 @@
 #include "chess.hpp"
 #include "ui_chess.h"
-#include "include/chess/square_widget.hpp"
-#include <QFile>
+#include <QLabel>
 #include <QResizeEvent>
 #include <algorithm>
 #include <QShortcut>
+#include <QStringList>
 #include <QTimer>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QFileDialog>
+#include <sstream>
 #include <include/chess/victory_screen.hpp>
 
 
@@ -16,9 +18,21 @@ using namespace chess;
 Chess::Chess(QWidget* parent) :
     QMainWindow(parent),
     _ui(new Ui::Chess),
-    _engine(),
-    _lightColor("rgb(232, 235, 239)"),
-    _darkColor("rgb(125, 135, 150)"),
+    _engineThread(),
+    _worker(nullptr),
+    _generation(0),
+    _snapshot(),
+    _analyser(new Analyser(this)),
+    _analysisTimer(),
+    _analysisId(0),
+    _analysedPosition(0),
+    _openingIndex(),
+    _pieceCache(),
+    _board(nullptr),
+    _renderedImbalance(),
+    _historyModel(new MoveHistoryModel(this)),
+    _lightColor(232, 235, 239),
+    _darkColor(125, 135, 150),
     _borderBackground(0, 74, 158),
     _whiteIsFront(true)
 {
@@ -26,18 +40,31 @@ Chess::Chess(QWidget* parent) :
     setPalette(background);
     _ui->setupUi(this);
 
-    _ui->moveHistoryTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-    _ui->moveHistoryTableWidget->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    _ui->moveHistoryTableView->setModel(_historyModel);
+    _ui->moveHistoryTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    _ui->moveHistoryTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
     loadPieceSvgs();
 
     createBoard();
     createImbalanceGrid();
-    updateBoard();
+    startEngine();
+
+    _ui->analysisLabel->hide();
+    _ui->explorerTableWidget->hide();
+    _ui->explorerTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    _analysisTimer.setSingleShot(true);
+    _analysisTimer.setInterval(100);
+    connect(&_analysisTimer, &QTimer::timeout, this, &Chess::showAnalysis);
+    connect(_analyser, &Analyser::progressed, &_analysisTimer, [this] {
+        if(!_analysisTimer.isActive()) {
+            _analysisTimer.start();
+        }
+    });
 
     connect(_ui->previousButton, &QPushButton::clicked, this, &Chess::previousPosition);
     connect(_ui->nextButton, &QPushButton::clicked, this, &Chess::nextPosition);
-    connect(_ui->moveHistoryTableWidget, &QTableWidget::cellPressed, this, &Chess::selectPosition);
+    connect(_ui->moveHistoryTableView, &QTableView::pressed, this, &Chess::selectPosition);
 
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_Z), this, SLOT(previousPosition()));
     new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_Z), this, SLOT(nextPosition()));
@@ -79,145 +106,90 @@ void Chess::resizeBoard() {
 }
 
 void Chess::loadPieceSvgs() {
-    char pieceColor[] = "LD";
-    char pieceType[] = "PNBRQK";
-
-    _pieceSvgContents[0].clear();
-    _pieceSvgContents[1].clear();
-
-    for(short colorNo = 0; colorNo < 2; colorNo++) {
-        for(short typeNo = 0; typeNo < 6; typeNo++) {
-            QString filename = QString("svg/") + QString(pieceType[typeNo]) + QString(pieceColor[colorNo] + QString(".svg"));
-            QFile svgFile(filename);
-            svgFile.open(QIODevice::ReadOnly);
-            _pieceSvgContents[colorNo].push_back(svgFile.readAll());
-            svgFile.close();
-        }
-    }
-}
-
-void Chess::createBoard() {
-    for(short x = 0; x < 8; x++) {
-        _ui->boardGLayout->setColumnStretch(x, 1);
-        _ui->boardGLayout->setRowStretch(x, 1);
-        for(short y = 0; y < 8; y++) {
-            SquareWidget* pieceWidget = new SquareWidget(x, y, this);
-            pieceWidget->setAutoFillBackground(true);
-            _ui->boardGLayout->addWidget(pieceWidget, convertY(y), x);
-            connect(pieceWidget, &SquareWidget::clicked, this, &Chess::clickSquare);
-        }
-    }
-}
-
-void Chess::setStyle(short x, short y, QString squareArgs, QString additionalStyle) {
-    if(!Board::positionExists(x, y)) {
-        return;
-    }
-    QString styleSheet = QString(
-        "SquareWidget {"
-        "   background-color: %1;"
-        "   %2"
-        "}"
-        "%3"
-    ).arg((x + y) % 2 ? _lightColor : _darkColor, squareArgs, additionalStyle);
-    _ui->boardGLayout->itemAtPosition(convertY(y), x)->widget()->setStyleSheet(styleSheet);
+    _pieceCache.load("svg");
 }
 
-void Chess::setBackground(short x, short y) {
-    setStyle(x, y, "");
+void Chess::startEngine() {
+    qRegisterMetaType<EngineSnapshotPtr>("EngineSnapshotPtr");
+    _worker = new EngineWorker();
+    _worker->moveToThread(&_engineThread);
+    connect(&_engineThread, &QThread::finished, _worker, &QObject::deleteLater);
+    connect(_worker, &EngineWorker::snapshotReady, this, &Chess::applySnapshot);
+    connect(_worker, &EngineWorker::boardRejected, this, &Chess::rejectBoard);
+    _engineThread.start();
+
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QMetaObject::invokeMethod(worker, [worker, generation] {
+        worker->refresh(generation);
+    }, Qt::QueuedConnection);
 }
 
-void Chess::setBorder(short x, short y, QString borderColor, QString additionalStyle) {
-    QString border = QString(
-        "   border-style: solid;"
-        "   border-color: %1;"
-        "   border-width: 5px;"
-    ).arg(borderColor);
-    setStyle(x, y, border, additionalStyle);
+quint64 Chess::nextGeneration() {
+    _worker->cancelBefore(++_generation);
+    return _generation;
 }
 
-void Chess::setMovePosition(short x, short y) {
-    QString hover = QString(
-        "SquareWidget:hover {"
-        "   background-color: #66CC66;"
-        "}"
-    );
-    setBorder(x, y, "#66CC66", hover);
+void Chess::createBoard() {
+    _board = new BoardWidget(_pieceCache, this);
+    _board->setColors(_lightColor, _darkColor);
+    _board->setWhiteIsFront(_whiteIsFront);
+    _ui->boardGLayout->addWidget(_board, 0, 0);
+    connect(_board, &BoardWidget::clicked, this, &Chess::clickSquare);
 }
 
 void Chess::setCheck() {
-    auto checkPosition = _engine.getCheckPosition();
+    auto checkPosition = _snapshot->checkPosition;
     if(checkPosition.first != -1 && checkPosition.second != -1) {
-        setBorder(checkPosition.first, checkPosition.second, "#CC3333");
+        _board->setHighlight(checkPosition.first, checkPosition.second, BoardWidget::Highlight::Check);
     }
 }
 
 void Chess::updateBackgroundColor() {
-    for(short x = 0; x < 8; x++) {
-        for(short y = 0; y < 8; y++) {
-            setBackground(x, y);
-        }
-    }
+    _board->clearHighlights();
     setCheck();
-//    if(_engine.)
 }
 
 void Chess::updateBoard() {
-    updateBackgroundColor();
-    auto board = _engine.getBoard();
+    const auto& board = _snapshot->game.getBoard();
     for(short x = 0; x < 8; x++) {
         for(short y = 0; y < 8; y++) {
-            SquareWidget* pieceWidget = dynamic_cast<SquareWidget*>(_ui->boardGLayout->itemAtPosition(convertY(y), x)->widget());
-            Piece piece = board[x][y].piece;
-            if(piece.type == PieceType::None) {
-                pieceWidget->load(QByteArray());
-                continue;
-            }
-            size_t typeNo = static_cast<size_t>(piece.type) - 1;
-            size_t colorNo = static_cast<size_t>(piece.color);
-            pieceWidget->load(_pieceSvgContents[colorNo][typeNo]);
+            _board->setPiece(x, y, board[x][y].piece);
         }
     }
+    updateSelection();
     updateImbalanceGrid();
-    updateMoveHistory();
+    if(_snapshot->positionIndex > 0) {
+        _ui->moveHistoryTableView->setCurrentIndex(_historyModel->getIndex(_snapshot->positionIndex - 1));
+    }
 }
 
-void Chess::clearSelection() {
+void Chess::updateSelection() {
     updateBackgroundColor();
-    _engine.deselectPiece();
-}
-
-void Chess::updateMoveHistory() {
-    auto moveHistory = _engine.getMoveHistory();
-    _ui->moveHistoryTableWidget->clearContents();
-    if(moveHistory.size() != 0) {
-        int row = 0;
-        int column = Piece::colorIndex(moveHistory.front().getTurn());
-        int rowCount = (moveHistory.size() + 1 + column) / 2;
-        _ui->moveHistoryTableWidget->setRowCount(rowCount);
-        QStringList rowLabels;
-        rowLabels << QString("%1").arg(_engine.getStartingMoveIndex());
-        for(auto move : moveHistory) {
-            QTableWidgetItem* item = new QTableWidgetItem(QString::fromStdString(move.getAlgebraicNotation()));
-            _ui->moveHistoryTableWidget->setItem(row, column, item);
-            if(++column == 2) {
-                rowLabels << QString("%1").arg(_engine.getStartingMoveIndex() + ++row);
-                column = 0;
-            }
+    auto selectedPosition = _snapshot->selectedPosition;
+    if(selectedPosition.first != -1 && selectedPosition.second != -1) {
+        _board->setHighlight(selectedPosition.first, selectedPosition.second, BoardWidget::Highlight::Selected);
+        for(auto move : _snapshot->possibleMoves) {
+            _board->setHighlight(move.first, move.second, BoardWidget::Highlight::Move);
         }
-        _ui->moveHistoryTableWidget->setVerticalHeaderLabels(rowLabels);
-    } else {
-        _ui->moveHistoryTableWidget->setRowCount(0);
     }
 }
 
+void Chess::updateMoveHistory(const EngineSnapshot& snapshot) {
+    if(snapshot.historyReset) {
+        _historyModel->reset(snapshot.firstTurn, snapshot.startingMoveIndex);
+    }
+    _historyModel->update(snapshot.firstChangedPly, snapshot.changedMoves);
+}
+
 void Chess::createImbalanceGrid() {
     clearLayout(_ui->playerMaterialGLayout);
     clearLayout(_ui->enemyMaterialGLayout);
+    _renderedImbalance.clear();
     for(short x = 0; x < 6; x++) {
         for(short y = 0; y < 4; y++) {
-            QSvgWidget* frontWidget = new QSvgWidget(this);
-            QSvgWidget* backWidget = new QSvgWidget(this);
+            QLabel* frontWidget = new QLabel(this);
+            QLabel* backWidget = new QLabel(this);
             frontWidget->setFixedSize(32, 32);
             backWidget->setFixedSize(32, 32);
             _ui->playerMaterialGLayout->addWidget(frontWidget, y, x);
@@ -227,14 +199,18 @@ void Chess::createImbalanceGrid() {
 }
 
 void Chess::updateImbalanceGrid() {
-    auto imbalance = _engine.getMaterialImbalance();
+    const auto& imbalance = _snapshot->materialImbalance;
+    if(imbalance == _renderedImbalance) {
+        return;
+    }
+    _renderedImbalance = imbalance;
 
     for(short x = 0; x < 6; x++) {
         for(short y = 0; y < 4; y++) {
-            QSvgWidget* frontWidget = dynamic_cast<QSvgWidget*>(_ui->playerMaterialGLayout->itemAtPosition(y, x)->widget());
-            QSvgWidget* backWidget = dynamic_cast<QSvgWidget*>(_ui->enemyMaterialGLayout->itemAtPosition(y, x)->widget());
-            frontWidget->load(QByteArray());
-            backWidget->load(QByteArray());
+            QLabel* frontWidget = dynamic_cast<QLabel*>(_ui->playerMaterialGLayout->itemAtPosition(y, x)->widget());
+            QLabel* backWidget = dynamic_cast<QLabel*>(_ui->enemyMaterialGLayout->itemAtPosition(y, x)->widget());
+            frontWidget->clear();
+            backWidget->clear();
         }
     }
 
@@ -242,12 +218,12 @@ void Chess::updateImbalanceGrid() {
     short backRow, backColumn;
     frontRow = frontColumn = backRow = backColumn = 0;
     for(auto piece : imbalance) {
-        QSvgWidget* widget;
+        QLabel* widget;
         if(piece.color == (_whiteIsFront ? PieceColor::White : PieceColor::Black)) {
             if(frontRow == 4) {
                 continue;
             }
-            widget = dynamic_cast<QSvgWidget*>(_ui->playerMaterialGLayout->itemAtPosition(frontRow, frontColumn)->widget());
+            widget = dynamic_cast<QLabel*>(_ui->playerMaterialGLayout->itemAtPosition(frontRow, frontColumn)->widget());
             if(++frontColumn == 6) {
                 frontRow++;
                 frontColumn = 0;
@@ -256,13 +232,13 @@ void Chess::updateImbalanceGrid() {
             if(backRow == 4) {
                 continue;
             }
-            widget = dynamic_cast<QSvgWidget*>(_ui->enemyMaterialGLayout->itemAtPosition(3 - backRow, backColumn)->widget());
+            widget = dynamic_cast<QLabel*>(_ui->enemyMaterialGLayout->itemAtPosition(3 - backRow, backColumn)->widget());
             if(++backColumn == 6) {
                 backRow++;
                 backColumn = 0;
             }
         }
-        widget->load(_pieceSvgContents[Piece::colorIndex(piece.color)][static_cast<size_t>(piece.type) - 1]);
+        widget->setPixmap(_pieceCache.getPixmap(piece, widget->width(), widget->devicePixelRatioF()));
     }
 }
 
@@ -282,15 +258,12 @@ void Chess::clearLayout(QLayout* layout, bool deleteWidgets)
 }
 
 void Chess::generateBoard(const std::string& fen) {
-    try {
-    _engine.setBoard(fen);
-    updateBoard();
-    } catch(std::invalid_argument&) {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Error");
-        msgBox.setText("Couldn't create a position from the given fen.");
-        msgBox.exec();
-    }
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QString boardFen = QString::fromStdString(fen);
+    QMetaObject::invokeMethod(worker, [worker, generation, boardFen] {
+        worker->setBoard(generation, boardFen);
+    }, Qt::QueuedConnection);
 }
 
 void Chess::showWin(GameState state) {
@@ -300,74 +273,157 @@ void Chess::showWin(GameState state) {
     }
 }
 
-void Chess::clickSquare(short x, short y) {
-    auto position = std::make_pair(x, y);
-    auto selectedSquare = _engine.getSelectedSquare();
-    if(selectedSquare) {
-        if(selectedSquare->getPosition() == position) {
-            clearSelection();
-            return;
-        } else if(_engine.move(position)) {
-            updateBoard();
-            auto state = _engine.getGameState();
-            if(state != GameState::Playing) {
-                showWin(state);
-            }
-            return;
-        }
+void Chess::applySnapshot(EngineSnapshotPtr snapshot) {
+    updateMoveHistory(*snapshot);
+    if(snapshot->generation != _generation) {
+        return;
     }
-    if(_engine.getBoard()[x][y].piece.type != PieceType::None) {
-        if(_engine.selectPiece(position)) {
-            updateBackgroundColor();
-            setBorder(x, y, "#FFFF99");
-//            _ui->boardGLayout->itemAtPosition(convertY(y), x)->widget()->setStyleSheet("SquareWidget {border-style:solid;border-width:5px;border-color:yellow;}");
-//            QPalette selected(QPalette::Foreground, Qt::yellow);
-//            _ui->boardGLayout->itemAtPosition(convertY(y), x)->widget()->setPalette(selected);
-            for(auto move : _engine.getPossibleMoves()) {
-                setMovePosition(move.first, move.second);
-            }
-        }
+    _snapshot = snapshot;
+    updateBoard();
+    updateExplorer();
+    if(_ui->actionAnalysis->isChecked() && snapshot->positionVersion != _analysedPosition) {
+        startAnalysis();
+    }
+    if(snapshot->moved && snapshot->state != GameState::Playing) {
+        showWin(snapshot->state);
     }
 }
 
-bool Chess::selectPosition(int move, int color) {
-    if(color < 0 || color > 1) {
-        return false;
+void Chess::rejectBoard(quint64, const QString&) {
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("Error");
+    msgBox.setText("Couldn't create a position from the given fen.");
+    msgBox.exec();
+}
+
+void Chess::startAnalysis() {
+    _analysisId = _analyser->start(_snapshot->game);
+    _analysedPosition = _snapshot->positionVersion;
+    _ui->analysisLabel->setText("Analysing...");
+}
+
+void Chess::showAnalysis() {
+    AnalysisProgress progress;
+    if(!_analyser->takeProgress(progress) || progress.id != _analysisId) {
+        return;
     }
-    if(_engine.selectPosition(static_cast<size_t>(2 * move + color + 1))) {
-        updateBoard();
-        _ui->moveHistoryTableWidget->setCurrentCell(move, color);
-        return true;
+    const SearchResult& result = progress.result;
+    QString score;
+    if(result.isMate()) {
+        short mateDistance = result.getMateDistance();
+        score = QString("#%1").arg(progress.turn == PieceColor::White ? mateDistance : -mateDistance);
     } else {
+        int centipawns = progress.turn == PieceColor::White ? result.score : -result.score;
+        score = QString("%1%2").arg(centipawns > 0 ? "+" : "").arg(centipawns / 100.0, 0, 'f', 2);
+    }
+    qint64 nodesPerSecond = static_cast<qint64>(result.nodes * 1000 / static_cast<uint64_t>(std::max<qint64>(progress.milliseconds, 1)));
+    QStringList pv;
+    for(const auto& move : result.principalVariation) {
+        pv.append(QString::fromStdString(move.getCoordinateNotation()));
+    }
+    _ui->analysisLabel->setText(QString("Depth %1   %2   %3 kN/s\n%4")
+                                .arg(result.depth)
+                                .arg(score)
+                                .arg(nodesPerSecond / 1000)
+                                .arg(pv.join(' ')));
+}
+
+void Chess::updateExplorer() {
+    if(!_ui->actionExplorer->isChecked() || !_snapshot) {
+        return;
+    }
+    std::vector<OpeningMove> moves = _openingIndex.find(_snapshot->game);
+    QTableWidget* table = _ui->explorerTableWidget;
+    table->setRowCount(static_cast<int>(moves.size()));
+    for(int row = 0; row < static_cast<int>(moves.size()); row++) {
+        const OpeningMove& move = moves[row];
+        double games = move.getNoGames();
+        QStringList cells;
+        cells << QString::fromStdString(move.move.getCoordinateNotation())
+              << QString::number(move.getNoGames())
+              << QString("%1%").arg(100.0 * move.whiteWins / games, 0, 'f', 0)
+              << QString("%1%").arg(100.0 * move.draws / games, 0, 'f', 0)
+              << QString("%1%").arg(100.0 * move.blackWins / games, 0, 'f', 0);
+        for(int column = 0; column < cells.size(); column++) {
+            table->setItem(row, column, new QTableWidgetItem(cells[column]));
+        }
+    }
+}
+
+void Chess::clickSquare(short x, short y) {
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QMetaObject::invokeMethod(worker, [worker, generation, x, y] {
+        worker->click(generation, x, y);
+    }, Qt::QueuedConnection);
+}
+
+bool Chess::selectPosition(const QModelIndex& index) {
+    size_t ply = _historyModel->getPly(index);
+    if(ply == static_cast<size_t>(-1)) {
         return false;
     }
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QMetaObject::invokeMethod(worker, [worker, generation, ply] {
+        worker->selectPosition(generation, ply + 1);
+    }, Qt::QueuedConnection);
+    return true;
 }
 
 void Chess::previousPosition() {
-    auto positionIndex = _engine.previousPosition() - 1;
-    updateBoard();
-    if(positionIndex != -1) {
-        _ui->moveHistoryTableWidget->setCurrentCell(positionIndex / 2, positionIndex % 2);
-    }
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QMetaObject::invokeMethod(worker, [worker, generation] {
+        worker->previousPosition(generation);
+    }, Qt::QueuedConnection);
 }
 
 void Chess::nextPosition() {
-    auto positionIndex = _engine.nextPosition() - 1;
-    updateBoard();
-    if(positionIndex != -1) {
-        _ui->moveHistoryTableWidget->setCurrentCell(positionIndex / 2, positionIndex % 2);
-    }
+    EngineWorker* worker = _worker;
+    quint64 generation = nextGeneration();
+    QMetaObject::invokeMethod(worker, [worker, generation] {
+        worker->nextPosition(generation);
+    }, Qt::QueuedConnection);
 }
 
-short Chess::convertY(short y) {
-    if(_whiteIsFront) {
-        return 7 - y;
+void Chess::on_actionAnalysis_toggled(bool checked) {
+    _ui->analysisLabel->setVisible(checked);
+    if(checked) {
+        if(_snapshot) {
+            startAnalysis();
+        }
     } else {
-        return y;
+        _analyser->stop();
+        _analysisTimer.stop();
     }
 }
 
+void Chess::on_actionExplorer_toggled(bool checked) {
+    if(checked && !_openingIndex.isOpen()) {
+        QString filename = QFileDialog::getOpenFileName(this, "Open opening index", QString(), "Opening index (*.coi);;All files (*)");
+        if(filename.isEmpty()) {
+            _ui->actionExplorer->setChecked(false);
+            return;
+        }
+        try {
+            _openingIndex.open(filename.toStdString());
+        } catch(std::exception& e) {
+            QMessageBox msgBox(this);
+            msgBox.setWindowTitle("Error");
+            msgBox.setText(QString::fromStdString(e.what()));
+            msgBox.exec();
+            _ui->actionExplorer->setChecked(false);
+            return;
+        }
+    }
+    _ui->explorerTableWidget->setVisible(checked);
+    updateExplorer();
+}
+
 Chess::~Chess() {
+    _engineThread.quit();
+    _engineThread.wait();
     delete _ui;
 }
 
@@ -396,7 +452,19 @@ void Chess::on_actionCommands_triggered() {
     msgBox->setModal(false);
     msgBox->setWindowTitle("Shortcuts");
     msgBox->setText(QString("Ctrl + Z:\t\tUndo Move\n") +
-                   QString("Ctrl + Shift + Z:\tRedo Move"));
+                   QString("Ctrl + Shift + Z:\tRedo Move\n") +
+                   QString("Ctrl + A:\t\tToggle Analysis\n") +
+                   QString("Ctrl + E:\t\tToggle Opening Explorer"));
+    msgBox->show();
+}
+
+void Chess::on_actionEngineStatistics_triggered() {
+    std::ostringstream stats;
+    Engine::stats().print(stats);
+    QMessageBox* msgBox = new QMessageBox(this);
+    msgBox->setModal(false);
+    msgBox->setWindowTitle("Engine statistics");
+    msgBox->setText(QString("<pre>%1</pre>").arg(QString::fromStdString(stats.str()).toHtmlEscaped()));
     msgBox->show();
 }
 
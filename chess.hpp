@@ -2,8 +2,14 @@
 #define CHESS_HPP
 
 #include <QMainWindow>
-#include <QByteArray>
-#include "include/chess/engine/engine.hpp"
+#include <QThread>
+#include <QTimer>
+#include "include/chess/analyser.hpp"
+#include "include/chess/board_widget.hpp"
+#include "include/chess/engine/opening_index.hpp"
+#include "include/chess/engine_worker.hpp"
+#include "include/chess/move_history_model.hpp"
+#include "include/chess/piece_cache.hpp"
 
 namespace Ui {
 class Chess;
@@ -22,25 +28,28 @@ protected:
     void changeEvent(QEvent* event);
     void resizeBoard();
     void createBoard();
-    void setStyle(short x, short y, QString squareArgs, QString additionalStyle = "");
-    void setBackground(short x, short y);
-    void setBorder(short x, short y, QString borderColor, QString additionalStyle = "");
-    void setMovePosition(short x, short y);
     void setCheck();
     void updateBackgroundColor();
     void loadPieceSvgs();
+    void startEngine();
+    quint64 nextGeneration();
     void updateBoard();
-    void clearSelection();
-    void updateMoveHistory();
+    void updateSelection();
+    void updateMoveHistory(const EngineSnapshot& snapshot);
     void createImbalanceGrid();
     void updateImbalanceGrid();
     void clearLayout(QLayout* layout, bool deleteWidgets = true);
     void generateBoard(const std::string& fen);
     void showWin(chess::GameState state);
+    void startAnalysis();
+    void updateExplorer();
 
 protected slots:
+    void applySnapshot(EngineSnapshotPtr snapshot);
+    void rejectBoard(quint64 generation, const QString& fen);
+    void showAnalysis();
     void clickSquare(short x, short y);
-    bool selectPosition(int move, int color);
+    bool selectPosition(const QModelIndex& index);
     void previousPosition();
     void nextPosition();
 
@@ -48,15 +57,27 @@ private slots:
     void on_actionBoardGeneration_triggered();
     void on_actionAboutCreator_triggered();
     void on_actionCommands_triggered();
+    void on_actionEngineStatistics_triggered();
     void on_actionResetBoard_triggered();
+    void on_actionAnalysis_toggled(bool checked);
+    void on_actionExplorer_toggled(bool checked);
 
 private:
-    short convertY(short y);
-
     Ui::Chess* _ui;
-    chess::Engine _engine;
-    std::vector<QByteArray> _pieceSvgContents[2];
-    QString _lightColor, _darkColor;
+    QThread _engineThread;
+    EngineWorker* _worker;
+    quint64 _generation;
+    EngineSnapshotPtr _snapshot;
+    Analyser* _analyser;
+    QTimer _analysisTimer;
+    quint64 _analysisId;
+    quint64 _analysedPosition;
+    chess::OpeningIndex _openingIndex;
+    PieceCache _pieceCache;
+    BoardWidget* _board;
+    std::vector<chess::Piece> _renderedImbalance;
+    MoveHistoryModel* _historyModel;
+    QColor _lightColor, _darkColor;
     QColor _borderBackground;
     bool _whiteIsFront;
 };
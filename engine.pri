@@ -0,0 +1,56 @@
+# Engine sources shared by the GUI and the command line tools.
+
+INCLUDEPATH += $$PWD
+
+# qmake CONFIG+=stats enables the hot path counters behind Engine::stats().
+stats: DEFINES += CHESS_STATS
+
+SOURCES += \
+    $$PWD/src/arena.cpp \
+    $$PWD/src/board.cpp \
+    $$PWD/src/game.cpp \
+    $$PWD/src/game_archive.cpp \
+    $$PWD/src/game_rules.cpp \
+    $$PWD/src/legal_move_cache.cpp \
+    $$PWD/src/move.cpp \
+    $$PWD/src/move_generator.cpp \
+    $$PWD/src/move_info.cpp \
+    $$PWD/src/opening_index.cpp \
+    $$PWD/src/packed_position.cpp \
+    $$PWD/src/piece.cpp \
+    $$PWD/src/pressure_factory.cpp \
+    $$PWD/src/rules.cpp \
+    $$PWD/src/search.cpp \
+    $$PWD/src/square.cpp \
+    $$PWD/src/stats.cpp \
+    $$PWD/src/string_tok.cpp \
+    $$PWD/src/thread_pool.cpp \
+    $$PWD/src/variation_tree.cpp \
+    $$PWD/src/engine.cpp
+
+HEADERS += \
+    $$PWD/include/chess/engine/arena.hpp \
+    $$PWD/include/chess/engine/attack_tables.hpp \
+    $$PWD/include/chess/engine/board.hpp \
+    $$PWD/include/chess/engine/game.hpp \
+    $$PWD/include/chess/engine/game_archive.hpp \
+    $$PWD/include/chess/engine/game_rules.hpp \
+    $$PWD/include/chess/engine/legal_move_cache.hpp \
+    $$PWD/include/chess/engine/move.hpp \
+    $$PWD/include/chess/engine/move_generator.hpp \
+    $$PWD/include/chess/engine/move_info.hpp \
+    $$PWD/include/chess/engine/move_type.hpp \
+    $$PWD/include/chess/engine/opening_index.hpp \
+    $$PWD/include/chess/engine/packed_position.hpp \
+    $$PWD/include/chess/engine/piece.hpp \
+    $$PWD/include/chess/engine/pressure_factory.hpp \
+    $$PWD/include/chess/engine/rules.hpp \
+    $$PWD/include/chess/engine/search.hpp \
+    $$PWD/include/chess/engine/square.hpp \
+    $$PWD/include/chess/engine/stats.hpp \
+    $$PWD/include/chess/engine/string_tok.hpp \
+    $$PWD/include/chess/engine/thread_pool.hpp \
+    $$PWD/include/chess/engine/variation_tree.hpp \
+    $$PWD/include/chess/engine/zobrist.hpp \
+    $$PWD/include/chess/engine/engine.hpp \
+    $$PWD/include/chess/engine/game_state.hpp
@@ -0,0 +1,53 @@
+#ifndef ANALYSER_HPP
+#define ANALYSER_HPP
+
+#include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "engine/search.hpp"
+
+struct AnalysisProgress {
+    AnalysisProgress();
+
+    quint64 id;
+    chess::PieceColor turn;
+    chess::SearchResult result;
+    qint64 milliseconds;
+};
+
+// Runs an unbounded search on its own thread. Starting a new position stops
+// the current search at the next node; results are kept until the window
+// asks for them, so a burst of iterations costs one repaint.
+class Analyser : public QObject {
+    Q_OBJECT
+
+public:
+    explicit Analyser(QObject* parent = nullptr);
+    ~Analyser();
+
+    quint64 start(const chess::Game& game);
+    void stop();
+    bool takeProgress(AnalysisProgress& progress);
+
+signals:
+    void progressed();
+
+protected:
+    void run();
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::unique_ptr<chess::Game> _pending;
+    quint64 _id;
+    bool _quit;
+    std::atomic<bool> _stop;
+    AnalysisProgress _progress;
+    bool _updated;
+    std::thread _thread;
+};
+
+#endif // ANALYSER_HPP
@@ -0,0 +1,56 @@
+#ifndef BOARD_WIDGET_HPP
+#define BOARD_WIDGET_HPP
+
+#include <QColor>
+#include <QWidget>
+#include "engine/piece.hpp"
+
+class PieceCache;
+
+class BoardWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    enum class Highlight {
+        None,
+        Selected,
+        Move,
+        Check
+    };
+
+    explicit BoardWidget(PieceCache& pieceCache, QWidget* parent = nullptr);
+
+    void setPiece(short x, short y, chess::Piece piece);
+    void setHighlight(short x, short y, Highlight highlight);
+    void clearHighlights();
+    void setColors(const QColor& lightColor, const QColor& darkColor);
+    void setWhiteIsFront(bool whiteIsFront);
+
+    QSize sizeHint() const override;
+    bool hasHeightForWidth() const override;
+    int heightForWidth(int width) const override;
+
+signals:
+    void clicked(short x, short y);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+
+    int getSquareSize() const;
+    QRect getSquareRect(short x, short y) const;
+    bool getSquareAt(const QPoint& point, short& x, short& y) const;
+    void setHovered(short x, short y);
+
+private:
+    PieceCache& _pieceCache;
+    chess::Piece _pieces[8][8];
+    Highlight _highlights[8][8];
+    QColor _lightColor, _darkColor;
+    bool _whiteIsFront;
+    short _hoveredX, _hoveredY;
+};
+
+#endif // BOARD_WIDGET_HPP
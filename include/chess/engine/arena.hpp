@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace chess {
+
+// Bump allocator for transient engine containers. Deallocation is a no-op;
+// memory is handed back by rewinding a Scope, and chunks are kept for reuse
+// so a warmed up thread does not call malloc again.
+class Arena : public std::pmr::memory_resource {
+public:
+    class Scope {
+    public:
+        explicit Scope(Arena& arena);
+        Scope(const Scope& other) = delete;
+        ~Scope();
+
+        Scope& operator=(const Scope& other) = delete;
+
+    private:
+        Arena& _arena;
+        size_t _chunk;
+        size_t _offset;
+    };
+
+    explicit Arena(size_t chunkSize = 64 * 1024);
+    Arena(const Arena& other) = delete;
+
+    Arena& operator=(const Arena& other) = delete;
+
+    void reset();
+    size_t getCapacity() const;
+
+    static Arena& local();
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Chunk> _chunks;
+    size_t _chunkSize;
+    size_t _current;
+    size_t _offset;
+};
+
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace chess {
+
+// Per-square lookup tables generated at compile time. Squares are indexed
+// x * 8 + y like Board, masks use the same index as their bit number.
+
+enum class Direction {
+    North,
+    South,
+    East,
+    West,
+    NorthEast,
+    SouthEast,
+    SouthWest,
+    NorthWest,
+    Count
+};
+
+struct SquareList {
+    uint8_t size;
+    uint8_t squares[8];
+
+    constexpr const uint8_t* begin() const {
+        return squares;
+    }
+    constexpr const uint8_t* end() const {
+        return squares + size;
+    }
+};
+
+namespace tables {
+
+constexpr short directionX[] = {0, 0, 1, -1, 1, 1, -1, -1};
+constexpr short directionY[] = {1, -1, 0, 0, 1, -1, -1, 1};
+constexpr short knightX[] = {1, 2, 2, 1, -1, -2, -2, -1};
+constexpr short knightY[] = {2, 1, -1, -2, -2, -1, 1, 2};
+
+constexpr bool isOnBoard(short x, short y) {
+    return x >= 0 && x < 8 && y >= 0 && y < 8;
+}
+
+constexpr uint8_t toIndex(short x, short y) {
+    return static_cast<uint8_t>(x * 8 + y);
+}
+
+constexpr std::array<SquareList, 64> generateJumps(const short* stepX, const short* stepY) {
+    std::array<SquareList, 64> jumps{};
+    for(short square = 0; square < 64; square++) {
+        SquareList& list = jumps[square];
+        for(short i = 0; i < 8; i++) {
+            short x = square / 8 + stepX[i];
+            short y = square % 8 + stepY[i];
+            if(isOnBoard(x, y)) {
+                list.squares[list.size++] = toIndex(x, y);
+            }
+        }
+    }
+    return jumps;
+}
+
+constexpr std::array<std::array<SquareList, 8>, 64> generateRays() {
+    std::array<std::array<SquareList, 8>, 64> rays{};
+    for(short square = 0; square < 64; square++) {
+        for(short direction = 0; direction < 8; direction++) {
+            SquareList& ray = rays[square][direction];
+            short x = square / 8 + directionX[direction];
+            short y = square % 8 + directionY[direction];
+            while(isOnBoard(x, y)) {
+                ray.squares[ray.size++] = toIndex(x, y);
+                x += directionX[direction];
+                y += directionY[direction];
+            }
+        }
+    }
+    return rays;
+}
+
+constexpr short getDirection(short from, short to) {
+    short dx = to / 8 - from / 8;
+    short dy = to % 8 - from % 8;
+    if(from == to || (dx != 0 && dy != 0 && dx != dy && dx != -dy)) {
+        return -1;
+    }
+    for(short direction = 0; direction < 8; direction++) {
+        bool sameX = (dx > 0) == (directionX[direction] > 0) && (dx < 0) == (directionX[direction] < 0);
+        bool sameY = (dy > 0) == (directionY[direction] > 0) && (dy < 0) == (directionY[direction] < 0);
+        if(sameX && sameY) {
+            return direction;
+        }
+    }
+    return -1;
+}
+
+constexpr std::array<uint64_t, 64> generateMasks(const std::array<SquareList, 64>& lists) {
+    std::array<uint64_t, 64> masks{};
+    for(short square = 0; square < 64; square++) {
+        for(uint8_t target : lists[square]) {
+            masks[square] |= uint64_t(1) << target;
+        }
+    }
+    return masks;
+}
+
+constexpr std::array<std::array<uint64_t, 64>, 2> generatePawnAttacks() {
+    std::array<std::array<uint64_t, 64>, 2> attacks{};
+    for(short color = 0; color < 2; color++) {
+        short step = color == 0 ? 1 : -1;
+        for(short square = 0; square < 64; square++) {
+            for(short side = -1; side <= 1; side += 2) {
+                short x = square / 8 + side;
+                short y = square % 8 + step;
+                if(isOnBoard(x, y)) {
+                    attacks[color][square] |= uint64_t(1) << toIndex(x, y);
+                }
+            }
+        }
+    }
+    return attacks;
+}
+
+constexpr std::array<std::array<uint64_t, 64>, 64> generateBetween() {
+    std::array<std::array<uint64_t, 64>, 64> between{};
+    for(short from = 0; from < 64; from++) {
+        for(short to = 0; to < 64; to++) {
+            short direction = getDirection(from, to);
+            if(direction < 0) {
+                continue;
+            }
+            short x = from / 8 + directionX[direction];
+            short y = from % 8 + directionY[direction];
+            while(toIndex(x, y) != to) {
+                between[from][to] |= uint64_t(1) << toIndex(x, y);
+                x += directionX[direction];
+                y += directionY[direction];
+            }
+        }
+    }
+    return between;
+}
+
+constexpr std::array<std::array<uint64_t, 64>, 64> generateLines() {
+    std::array<std::array<uint64_t, 64>, 64> lines{};
+    for(short from = 0; from < 64; from++) {
+        for(short to = 0; to < 64; to++) {
+            short direction = getDirection(from, to);
+            if(direction < 0) {
+                continue;
+            }
+            uint64_t line = uint64_t(1) << from;
+            for(short sign = -1; sign <= 1; sign += 2) {
+                short x = from / 8 + sign * directionX[direction];
+                short y = from % 8 + sign * directionY[direction];
+                while(isOnBoard(x, y)) {
+                    line |= uint64_t(1) << toIndex(x, y);
+                    x += sign * directionX[direction];
+                    y += sign * directionY[direction];
+                }
+            }
+            lines[from][to] = line;
+        }
+    }
+    return lines;
+}
+
+}
+
+inline short lowestSquare(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<short>(__builtin_ctzll(mask));
+#else
+    short square = 0;
+    while(!(mask & 1)) {
+        mask >>= 1;
+        square++;
+    }
+    return square;
+#endif
+}
+
+// Squares a knight or king standing on the square attacks.
+inline constexpr std::array<SquareList, 64> knightTargets = tables::generateJumps(tables::knightX, tables::knightY);
+inline constexpr std::array<SquareList, 64> kingTargets = tables::generateJumps(tables::directionX, tables::directionY);
+
+// The same targets as masks, and the squares a pawn attacks, by
+// Piece::colorIndex.
+inline constexpr std::array<uint64_t, 64> knightMasks = tables::generateMasks(knightTargets);
+inline constexpr std::array<uint64_t, 64> kingMasks = tables::generateMasks(kingTargets);
+inline constexpr std::array<std::array<uint64_t, 64>, 2> pawnAttackMasks = tables::generatePawnAttacks();
+
+// Squares reached by sliding from the square in each Direction, nearest first.
+inline constexpr std::array<std::array<SquareList, 8>, 64> rays = tables::generateRays();
+
+// Squares strictly between two squares sharing a rank, file or diagonal, and
+// the whole line through them; both are empty when the squares aren't aligned.
+inline constexpr std::array<std::array<uint64_t, 64>, 64> betweenMasks = tables::generateBetween();
+inline constexpr std::array<std::array<uint64_t, 64>, 64> lineMasks = tables::generateLines();
+
+static_assert(knightTargets[0].size == 2 && kingTargets[0].size == 3, "corner jumps");
+static_assert(pawnAttackMasks[0][tables::toIndex(4, 1)] == ((uint64_t(1) << tables::toIndex(3, 2)) | (uint64_t(1) << tables::toIndex(5, 2))), "pawn attacks");
+static_assert(rays[0][static_cast<short>(Direction::NorthEast)].size == 7, "long diagonal");
+static_assert(betweenMasks[0][63] == lineMasks[0][63] - (uint64_t(1) << 0) - (uint64_t(1) << 63), "diagonal masks");
+
+}
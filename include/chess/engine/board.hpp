@@ -1,30 +1,42 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
 #include "square.hpp"
 
 namespace chess {
 
 class BoardHelper;
+class ConstBoardHelper;
 
 class Board {
 public:
 	Board();
+#ifdef CHESS_STATS
+	Board(const Board& other);
+
+	Board& operator=(const Board& other);
+#else
 	Board(const Board& other) = default;
 
 	Board& operator=(const Board& other) = default;
+#endif
 
 	BoardHelper operator[](short x);
+	ConstBoardHelper operator[](short x) const;
 	Square& operator[](const std::string& position);
+	const Square& operator[](const std::string& position) const;
     Square& operator[](const std::pair<short, short>& position);
+    const Square& operator[](const std::pair<short, short>& position) const;
+	Square& getSquare(short index);
+	const Square& getSquare(short index) const;
 
-    bool operator==(Board& other);
-    bool operator!=(Board& other);
+    bool operator==(const Board& other) const;
+    bool operator!=(const Board& other) const;
 
 	static bool positionExists(short x, short y);
 	static bool positionExists(const std::pair<short, short>& position);
 private:
-	std::unordered_map<std::pair<short, short>, Square, PairHash> _board;
+	std::array<Square, 64> _board;
 };
 
 class BoardHelper {
@@ -36,4 +48,13 @@ private:
 	const short _x;
 };
 
+class ConstBoardHelper {
+public:
+	ConstBoardHelper(const Board& board, short x);
+	const Square& operator[](short y) const;
+private:
+	const Board& _board;
+	const short _x;
+};
+
 }
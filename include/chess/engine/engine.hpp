@@ -1,7 +1,12 @@
 #pragma once
 
-#include "game_rules.hpp"
+#include <unordered_set>
+#include "legal_move_cache.hpp"
 #include "move_info.hpp"
+#include "rules.hpp"
+#include "search.hpp"
+#include "stats.hpp"
+#include "variation_tree.hpp"
 
 namespace chess {
 
@@ -10,35 +15,53 @@ public:
     Engine();
 
 	bool selectPiece(const std::pair<short, short>& piecePosition);
-    Square* getSelectedSquare();
+    const Square* getSelectedSquare();
     void deselectPiece();
     bool move(const std::pair<short, short>& destination);
 
     bool selectPosition(size_t position);
     size_t previousPosition();
     size_t nextPosition();
+    std::vector<MoveInfo> getVariations();
+    bool selectVariation(size_t variation);
 
 	void setBoard(const std::string& fen);
-    Board getBoard();
+    const Board& getBoard();
+    const Game& getGame() const;
 	GameState getGameState();
+    PieceColor getTurn();
 
     short getStartingMoveIndex();
+    size_t getPositionIndex() const;
     std::pair<short, short> getCheckPosition();
 	std::unordered_set<std::pair<short, short>, PairHash> getPossibleMoves();
-    std::vector<MoveInfo> getMoveHistory();
+    std::vector<Move> getLegalMoves();
+    std::vector<MoveInfo> getMoveHistory(size_t firstPly = 0);
+    size_t getHistorySize() const;
+    const Game& getStartingPosition() const;
+    std::vector<Move> getMoves() const;
     std::vector<Piece> getMaterialImbalance();
 
+    SearchResult analyse(const SearchLimits& limits);
+    size_t getMemoryUsage() const;
+
+    static Stats stats();
+    static void resetStats();
+
 protected:
-    void cutFutureMoves();
+    void updatePosition();
+    void followContinuations();
     void setGameState();
-    MoveInfo createMoveInfo(const std::pair<short, short>& destination, MoveType moveType, PieceColor turn);
+    std::string getNotation(const Game& game, const Move& move);
 
 private:
-    std::vector<Game> _positionHistory;
-    std::vector<MoveInfo> _moveHistory;
+    VariationTree _variationTree;
+    std::vector<uint32_t> _line;
     size_t _currentGameIndex;
 	Game _currentGame;
-    GameRules _gameRules;
+    LegalMoveCache _legalMoveCache;
+    std::shared_ptr<const LegalMoves> _legalMoves;
+    const Square* _selectedSquare;
 };
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <stack>
 #include <memory>
 #include <string>
@@ -13,6 +14,7 @@ namespace chess {
 class Game {
 public:
     friend class GameRules;
+    friend class PackedPosition;
 
     Game(const std::string& fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -");
     Game(const Game& other);
@@ -28,15 +30,20 @@ public:
     );
 
     void setGameState(GameState state);
-    GameState getGameState();
+    GameState getGameState() const;
 
-    Board getBoard() const;
+    const Board& getBoard() const;
     PieceColor getTurn() const;
     Square* getWhiteKingSquare() const;
     Square* getBlackKingSquare() const;
     Square* getEnPassantSquare() const;
     short getNoHalfMoves() const;
     short getNoMoves() const;
+    // The en passant file only counts when there is a pawn to take, so a
+    // FEN naming a square with no pawn in front of it hashes like "-".
+    uint64_t getHash() const;
+    short getPieceCount(PieceColor color, PieceType type) const;
+    uint64_t getMaterialKey() const;
 
     bool canWhiteCastleA() const;
     bool canWhiteCastleH() const;
@@ -48,8 +55,12 @@ protected:
             const std::pair<short, short>& origin,
             const std::pair<short, short>& destination
     );
+    void addMaterial(Piece piece, short count);
 private:
     void swap(Game& other);
+    // Square of the pawn that can be taken en passant, -1 when the en
+    // passant square has no such pawn in front of it.
+    short getEnPassantPawn() const;
 
     Board _board;
     PieceColor _turn;
@@ -60,6 +71,8 @@ private:
     bool _blackCastleA;
     bool _blackCastleH;
     GameState _state;
+    // Number of pieces of every colour and type, four bits each.
+    uint64_t _materialKey;
     Square* _whiteKingSquare;
     Square* _blackKingSquare;
     Square* _enPassantSquare;
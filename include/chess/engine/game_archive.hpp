@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "engine.hpp"
+#include "packed_position.hpp"
+
+namespace chess {
+
+// Games stored as one byte per ply, the index of the move in rules::legalMoves
+// of the position it was played from. An archive starts with "CGA1" and then
+// holds one record per game:
+//   flags     result in the low two bits, 4 when the start is not the usual one
+//   start     only with flag 4: a PackedPosition, then the half move clock and
+//             the move number as two bytes each
+//   plies     little endian base 128 varint, at most MaxPlies
+//   moves     one byte per ply
+// Indexes follow the generator's move order, so a change to that order needs
+// a new magic.
+struct ArchivedGame {
+    static const size_t MaxPlies = 65535;
+
+    ArchivedGame();
+
+    Game getStartingPosition() const;
+    // Calls visitor with every position of the game and the move played from it.
+    void replay(const std::function<void(const Game&, const Move&)>& visitor) const;
+    std::vector<Move> getMoves() const;
+
+    bool customStart;
+    PackedPosition start;
+    short noHalfMoves;
+    short noMoves;
+    GameState result;
+    std::vector<uint8_t> moves;
+};
+
+class GameArchiveWriter {
+public:
+    explicit GameArchiveWriter(std::ostream& os);
+
+    void write(const Engine& engine, GameState result);
+    void write(const Game& start, const std::vector<Move>& moves, GameState result);
+    size_t getNoGames() const;
+
+private:
+    std::ostream& _os;
+    size_t _noGames;
+};
+
+class GameArchiveReader {
+public:
+    explicit GameArchiveReader(std::istream& is);
+
+    // Returns false once the archive is exhausted.
+    bool read(ArchivedGame& game);
+
+private:
+    void readBytes(void* data, size_t size);
+
+    std::istream& _is;
+};
+
+}
@@ -2,6 +2,8 @@
 
 #include "game.hpp"
 #include "pressure_factory.hpp"
+#include "move.hpp"
+#include <memory_resource>
 #include <unordered_set>
 
 namespace chess {
@@ -9,6 +11,9 @@ namespace chess {
 class GameRules {
 public:
 	GameRules(const Game& game);
+	GameRules(const GameRules& other) = delete;
+
+	GameRules& operator=(const GameRules& other) = delete;
 
 	void selectGame(const Game& game);
 	void updatePosition();
@@ -18,8 +23,11 @@ public:
 	MoveType getMoveType(const std::pair<short, short>& destination);
     bool isCheck(PieceColor turn);
 
-        Square* getSelectedSquare();
+        const Square* getSelectedSquare() const;
 	std::unordered_set<std::pair<short, short>, PairHash> getPossibleMoves();
+	bool hasPossibleMoves() const;
+	std::pmr::vector<Move> getLegalMoves(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	bool hasLegalMoves();
 protected:
 	void updatePossibleMoves();
         void setPossibleMoves();
@@ -30,8 +38,10 @@ protected:
 	bool blackCanCastleA();
 	bool blackCanCastleH();
 
-	Square* getPinningSquare(short originX, short originY, short stepX, short stepY);
-	bool enemyCanAttack(Board board, const std::pair<short, short>& destination);
+	const Board& getBoard() const;
+	const Square* getPinningSquare(short originX, short originY, short stepX, short stepY);
+	bool isOnOpenLine(const std::pair<short, short>& from, const std::pair<short, short>& to) const;
+	bool enemyCanAttack(const Board& board, const std::pair<short, short>& destination);
 	void addMove(const std::pair<short, short>& destination, MoveType moveType);
 	void removeMove(const std::pair<short, short>& destination);
 	bool isEnemy(const std::pair<short, short>& position);
@@ -41,9 +51,9 @@ protected:
 	bool isEnemy(short x, short y);
 private:
 	const Game* _game;
-	Board _board;
-	Square* _currentSquare;
-	std::unordered_map<std::pair<short, short>, MoveType, PairHash> _moves;
+	const Square* _currentSquare;
+	std::pmr::unsynchronized_pool_resource _pool;
+	std::pmr::unordered_map<std::pair<short, short>, MoveType, PairHash> _moves;
 };
 
 }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "move.hpp"
+
+namespace chess {
+
+// Every legal move of one position, grouped by origin square so the moves
+// of a selected piece are a contiguous range.
+class LegalMoves {
+public:
+    LegalMoves(const Move* first, const Move* last);
+
+    const std::vector<Move>& getMoves() const;
+    const Move* begin(short origin) const;
+    const Move* end(short origin) const;
+    bool empty() const;
+
+private:
+    std::vector<Move> _moves;
+    std::array<uint8_t, 65> _offsets;
+};
+
+// Small least recently used map from Game::getHash to the position's legal
+// moves. It is sized for stepping back and forth through a game's history.
+class LegalMoveCache {
+public:
+    static const size_t Capacity = 8;
+
+    LegalMoveCache();
+
+    std::shared_ptr<const LegalMoves> find(uint64_t hash);
+    std::shared_ptr<const LegalMoves> insert(uint64_t hash, std::shared_ptr<const LegalMoves> moves);
+    void clear();
+    size_t getMemoryUsage() const;
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint64_t lastUse;
+        std::shared_ptr<const LegalMoves> moves;
+    };
+
+    std::vector<Entry> _entries;
+    uint64_t _clock;
+};
+
+}
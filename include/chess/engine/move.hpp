@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include "move_type.hpp"
+
+namespace chess {
+
+struct Move {
+    Move();
+    Move(
+            const std::pair<short, short>& origin,
+            const std::pair<short, short>& destination,
+            MoveType type
+    );
+
+    bool operator==(const Move& other) const;
+    bool operator!=(const Move& other) const;
+
+    std::string getCoordinateNotation() const;
+
+    std::pair<short, short> origin;
+    std::pair<short, short> destination;
+    MoveType type;
+};
+
+}
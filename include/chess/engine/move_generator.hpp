@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "game.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+// Legal moves of one position computed from occupancy masks and the attack
+// tables, with checks and pins found once up front instead of replaying
+// every candidate move. It follows GameRules move for move, queen only
+// promotions and castling rules included. Nothing is modified after
+// construction, so one instance can be queried from several threads.
+class MoveGenerator {
+public:
+    explicit MoveGenerator(const Game& game);
+
+    std::pmr::vector<Move> getLegalMoves(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+    bool hasLegalMoves() const;
+    bool isCheck() const;
+
+    // Squares of the pieces of color attacking square, sliders looking
+    // through everything missing from occupied.
+    uint64_t getAttackers(short square, PieceColor color) const;
+    uint64_t getAttackers(short square, PieceColor color, uint64_t occupied) const;
+    uint64_t getOccupied() const;
+    // Static exchange evaluation of move, see rules::see.
+    int see(const Move& move) const;
+
+protected:
+    bool generate(std::pmr::vector<Move>* moves) const;
+    bool generatePawnMoves(short origin, uint64_t allowed, std::pmr::vector<Move>* moves) const;
+    bool generateKingMoves(std::pmr::vector<Move>* moves) const;
+    bool canCastle(short rookX, short lastX) const;
+    bool isEnPassantLegal(short origin, short destination) const;
+
+    PieceType getLeastValuable(uint64_t pieces, short& square) const;
+
+    static uint64_t getRayAttacks(short square, short firstDirection, short lastDirection, uint64_t occupied);
+    static bool addMove(short origin, short destination, MoveType type, std::pmr::vector<Move>* moves);
+
+private:
+    const Game& _game;
+    PieceColor _us;
+    PieceColor _them;
+    uint64_t _occupied;
+    uint64_t _colors[2];
+    uint64_t _pieces[7];
+    short _king;
+    uint64_t _checkers;
+    uint64_t _pinned;
+};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "game_archive.hpp"
+#include "thread_pool.hpp"
+
+namespace chess {
+
+struct OpeningMove {
+    OpeningMove();
+
+    uint32_t getNoGames() const;
+
+    Move move;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+};
+
+// Read only view of an index file: a 16 byte header ("COI1", four reserved
+// bytes, the number of entries) followed by entries sorted by Game::getHash
+// and move, in native byte order. The file is memory mapped, so opening it
+// reads nothing and a lookup is a binary search over the pages it touches.
+class OpeningIndex {
+public:
+    struct Entry {
+        uint64_t hash;
+        uint8_t origin;
+        uint8_t destination;
+        uint8_t type;
+        uint8_t reserved;
+        uint32_t whiteWins;
+        uint32_t draws;
+        uint32_t blackWins;
+    };
+
+    static const char Magic[4];
+    static const size_t HeaderSize = 16;
+
+    OpeningIndex();
+    OpeningIndex(const OpeningIndex& other) = delete;
+    ~OpeningIndex();
+
+    OpeningIndex& operator=(const OpeningIndex& other) = delete;
+
+    void open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    size_t size() const;
+
+    // Moves played from the position, most played first.
+    std::vector<OpeningMove> find(const Game& game) const;
+    std::vector<OpeningMove> find(uint64_t hash) const;
+
+private:
+    const Entry* _entries;
+    size_t _noEntries;
+    void* _mapping;
+    size_t _mappingSize;
+};
+
+// Counts every move of the first maxPlies plies of the games it is given.
+// add may be called from any number of threads; each thread counts into a
+// table of its own, and write sorts the tables in parallel and merges them.
+class OpeningIndexBuilder {
+public:
+    explicit OpeningIndexBuilder(short maxPlies = 30);
+
+    void add(const ArchivedGame& game);
+    void add(const Game& start, const std::vector<Move>& moves, GameState result);
+    // Writes every move played in at least minGames games, returns the number of entries.
+    size_t write(const std::string& filename, ThreadPool& pool, uint32_t minGames = 1);
+
+    size_t getNoGames() const;
+    size_t getNoPlies() const;
+
+private:
+    struct Counts {
+        uint32_t whiteWins;
+        uint32_t draws;
+        uint32_t blackWins;
+    };
+
+    struct Key {
+        bool operator==(const Key& other) const;
+
+        uint64_t hash;
+        uint32_t move;
+    };
+
+    struct KeyHash {
+        inline size_t operator()(const Key& key) const {
+            return static_cast<size_t>(key.hash ^ (key.move * 0x9e3779b97f4a7c15ull));
+        }
+    };
+
+    struct Partial {
+        std::unordered_map<Key, Counts, KeyHash> counts;
+        size_t noGames = 0;
+        size_t noPlies = 0;
+    };
+
+    Partial& getPartial();
+    void count(Partial& partial, const Game& position, const Move& move, GameState result);
+
+    short _maxPlies;
+    mutable std::mutex _mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<Partial>> _partials;
+};
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "game.hpp"
+
+namespace chess {
+
+// A position in 33 bytes: a nibble per square, x * 8 + y like Board, and a
+// byte for the side to move and castling rights. A pawn that can be taken
+// en passant has a nibble of its own, so an en passant square without that
+// pawn in front of it is dropped. Move counters and the game state are left
+// out; games that reach the same position pack to equal keys.
+class PackedPosition {
+public:
+    PackedPosition();
+    explicit PackedPosition(const Game& game);
+
+    // False for bytes no position packs to: unknown piece codes, other than
+    // one king per side, more pieces of a kind than a FEN allows, or an en
+    // passant pawn off its double step rank. unpack expects a valid position.
+    bool isValid() const;
+
+    // The move counters are not packed, so they are given here.
+    Game unpack(short noHalfMoves = 0, short noMoves = 1) const;
+
+    Piece getPiece(short square) const;
+    uint64_t getOccupied() const;
+    PieceColor getTurn() const;
+    short getEnPassantSquare() const;
+    bool canWhiteCastleA() const;
+    bool canWhiteCastleH() const;
+    bool canBlackCastleA() const;
+    bool canBlackCastleH() const;
+
+    // Equal to Game::getHash of the position it was packed from.
+    uint64_t getHash() const;
+
+    bool operator==(const PackedPosition& other) const;
+    bool operator!=(const PackedPosition& other) const;
+    bool operator<(const PackedPosition& other) const;
+
+private:
+    static const uint8_t EnPassantPawn = 7;
+    static const uint8_t BlackToMove = 1;
+    static const uint8_t WhiteCastleA = 2;
+    static const uint8_t WhiteCastleH = 4;
+    static const uint8_t BlackCastleA = 8;
+    static const uint8_t BlackCastleH = 16;
+
+    uint8_t getCode(short square) const;
+    void setCode(short square, uint8_t code);
+
+    std::array<uint8_t, 32> _squares;
+    uint8_t _state;
+};
+
+static_assert(sizeof(PackedPosition) == 33, "packed position size");
+
+struct PackedPositionHash {
+    inline std::size_t operator()(const PackedPosition& position) const {
+        return static_cast<std::size_t>(position.getHash());
+    }
+};
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace chess {
 
 enum class PieceType{
@@ -24,10 +26,10 @@ struct Piece {
 	Piece();
     Piece(char piece);
 
-    bool operator!=(const Piece other);
-    bool operator==(const Piece other);
+    bool operator!=(const Piece other) const;
+    bool operator==(const Piece other) const;
 
-    operator char();
+    operator char() const;
 
     static size_t colorIndex(PieceColor color);
 };
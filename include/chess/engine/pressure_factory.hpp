@@ -1,32 +1,37 @@
 #pragma once
 
+#include <memory_resource>
+#include <unordered_map>
+#include "attack_tables.hpp"
 #include "board.hpp"
 #include "move_type.hpp"
 
 namespace chess {
 
+// Moves are kept in the given resource. Pass Arena::local() only while
+// holding an Arena::Scope, as the arena gets nothing back until it rewinds.
 class PressureFactory {
 public:
-	PressureFactory(Board board, const std::pair<short, short>& piecePosition);
+	PressureFactory(const Board& board, const std::pair<short, short>& piecePosition,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 	
 	bool canAttack(const std::pair<short, short> destination);
-	std::unordered_map<std::pair<short, short>, MoveType, PairHash> getMoves();
+	const std::pmr::unordered_map<std::pair<short, short>, MoveType, PairHash>& getMoves() const;
 
 protected:
 	void generateMoves();
-	void generateVerticalMoves(bool multiMove = false);
-	void generateHorizontalMoves(bool multiMove = false);
-	void generateDiagonalMoves(bool multiMove = false);
-	void generateJumpMoves();
+	void generateRayMoves(Direction first, Direction last);
+	void generateJumpMoves(const std::array<SquareList, 64>& targets);
+	bool addMove(short index);
 	bool addMove(short x, short y, MoveType moveType = MoveType::Normal);
 	bool addMove(const std::pair<short, short>& position, MoveType moveType = MoveType::Normal);
 	bool isEnemy(short x, short y);
 	bool isEnemy(const std::pair<short, short>& position);
 
 private:
-	Board _board;
-	Square& _selectedSquare;
-	std::unordered_map<std::pair<short, short>, MoveType, PairHash> _moves;
+	const Board& _board;
+	const Square& _selectedSquare;
+	std::pmr::unordered_map<std::pair<short, short>, MoveType, PairHash> _moves;
 };
 
 }
\ No newline at end of file
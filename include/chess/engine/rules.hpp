@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include "game.hpp"
+#include "game_state.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+// Rule queries as pure functions of a position. Nothing is kept between
+// calls, so any number of threads may ask about positions they share.
+namespace rules {
+
+std::pmr::vector<Move> legalMoves(const Game& game, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+bool hasLegalMoves(const Game& game);
+// The legal move from origin to destination, or a move of type None.
+Move findMove(const Game& game, const std::pair<short, short>& origin, const std::pair<short, short>& destination);
+
+bool isCheck(const Game& game, PieceColor color);
+// Material the side to move ends up with after move and the best run of
+// captures on its destination for both sides, in centipawns. Pins are
+// ignored, so this can only be a guide.
+int see(const Game& game, const Move& move);
+// Material value in centipawns; the king has none.
+int pieceValue(PieceType type);
+bool isInsufficientMaterial(const Game& game);
+// State of a position that has now occurred noRepetitions times.
+GameState gameState(const Game& game, short noRepetitions = 1);
+
+}
+
+}
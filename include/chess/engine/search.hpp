@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "game.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+class MoveGenerator;
+
+struct SearchLimits {
+    SearchLimits();
+
+    short depth;
+    uint64_t nodes;
+    std::chrono::milliseconds time;
+    const std::atomic<bool>* stop;
+};
+
+struct SearchResult {
+    SearchResult();
+
+    bool isMate() const;
+    short getMateDistance() const;
+
+    Move bestMove;
+    int score;
+    short depth;
+    std::vector<Move> principalVariation;
+    uint64_t nodes;
+};
+
+class Search {
+public:
+    static const int MateScore = 100000;
+    static const short MaxDepth = 64;
+
+    // Called with the result of every completed iteration.
+    using Listener = std::function<void(const SearchResult&)>;
+
+    Search(const Game& game);
+
+    SearchResult run(const SearchLimits& limits, const Listener& listener = Listener());
+
+protected:
+    int negamax(const Game& game, short depth, short ply, int alpha, int beta, std::pmr::vector<Move>& pv);
+    bool shouldAbort();
+    int evaluate(const Game& game);
+    void orderMoves(const Game& game, const MoveGenerator* generator, std::pmr::vector<Move>& moves, const Move& bestMove);
+
+private:
+    Game _game;
+    SearchLimits _limits;
+    uint64_t _nodes;
+    bool _aborted;
+    std::chrono::steady_clock::time_point _start;
+    std::vector<Move> _previousPv;
+};
+
+}
@@ -14,16 +14,17 @@ struct PairHash {
 };
 
 struct Square {
+	Square();
 	Square(const short& x, const short& y);
 	Square(const std::pair<short, short>& position);
 	Square(const std::string& position);
 	Square(const Square& other) = default;
 
-	short getX();
-	short getY();
-	std::pair<short, short> getPosition();
+	short getX() const;
+	short getY() const;
+	std::pair<short, short> getPosition() const;
 
-	operator std::string();
+	operator std::string() const;
 
 	static std::pair<short, short> convertPosition(const std::string& position);
 	static std::string convertPosition(const std::pair<short, short>& position);
@@ -36,6 +37,6 @@ private:
 	short _x, _y;
 };
 
-std::ostream& operator<<(std::ostream& os, Square square);
+std::ostream& operator<<(std::ostream& os, const Square& square);
 
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace chess {
+
+enum class StatsCounter {
+    GameCopies,
+    BoardCopies,
+    // PressureFactory and GameRules, which Engine and Search no longer use.
+    PressureFactories,
+    EnemyCanAttack,
+    SetGameState,
+    // MoveGenerator, behind the rules API used by Engine and Search.
+    MoveGeneration,
+    GetAttackers,
+    Count
+};
+
+struct StatsEntry {
+    uint64_t count;
+    uint64_t nanoseconds;
+};
+
+// Process wide hot path counters. They are only collected when the engine
+// is built with CHESS_STATS defined (qmake CONFIG+=stats); otherwise the
+// macros below expand to nothing and every snapshot is empty.
+class Stats {
+public:
+    Stats();
+
+    const StatsEntry& operator[](StatsCounter counter) const;
+    void print(std::ostream& os) const;
+
+    static bool isEnabled();
+    static Stats snapshot();
+    static void reset();
+    static void record(StatsCounter counter, std::chrono::nanoseconds elapsed);
+    static const char* getName(StatsCounter counter);
+
+private:
+    StatsEntry _entries[static_cast<size_t>(StatsCounter::Count)];
+};
+
+class StatsTimer {
+public:
+    explicit StatsTimer(StatsCounter counter);
+    StatsTimer(const StatsTimer& other) = delete;
+    ~StatsTimer();
+
+    StatsTimer& operator=(const StatsTimer& other) = delete;
+
+private:
+    StatsCounter _counter;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}
+
+#ifdef CHESS_STATS
+#define CHESS_STATS_CONCAT_(a, b) a##b
+#define CHESS_STATS_CONCAT(a, b) CHESS_STATS_CONCAT_(a, b)
+#define CHESS_STATS_TIME(counter) \
+    ::chess::StatsTimer CHESS_STATS_CONCAT(statsTimer, __LINE__)(::chess::StatsCounter::counter)
+#else
+#define CHESS_STATS_TIME(counter) ((void)0)
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chess {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t noThreads = 0);
+    ThreadPool(const ThreadPool& other) = delete;
+    ~ThreadPool();
+
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+    size_t size() const;
+
+    static size_t defaultSize();
+
+protected:
+    void run(size_t index);
+    bool popTask(size_t index, std::function<void()>& task);
+    bool stealTask(size_t index, std::function<void()>& task);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    std::condition_variable _idle;
+    size_t _queued;
+    size_t _pending;
+    size_t _nextQueue;
+    bool _stopping;
+};
+
+}
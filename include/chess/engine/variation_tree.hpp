@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "game.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+// Every line played from one starting position. Nodes only record the move
+// that reached them; positions are rebuilt by replaying from the nearest
+// checkpoint, a full Game kept every CheckpointInterval plies. Notation is
+// filled in by whoever first asks for it.
+class VariationTree {
+public:
+    static const uint32_t NoNode = UINT32_MAX;
+    static const uint32_t Root = 0;
+    static const short CheckpointInterval = 16;
+
+    VariationTree(const Game& game = Game());
+
+    void reset(const Game& game);
+    uint32_t findChild(uint32_t parent, const Move& move) const;
+    uint32_t addChild(uint32_t parent, const Move& move, const Game& position);
+
+    Game getPosition(uint32_t node) const;
+    const Game& getRootPosition() const;
+    void applyMove(uint32_t node, Game& game) const;
+    Move getMove(uint32_t node) const;
+    bool hasNotation(uint32_t node) const;
+    const char* getNotation(uint32_t node) const;
+    void setNotation(uint32_t node, const std::string& notation);
+    uint64_t getHash(uint32_t node) const;
+    GameState getGameState(uint32_t node) const;
+    std::vector<uint32_t> getChildren(uint32_t node) const;
+
+    uint32_t getContinuation(uint32_t node) const;
+    void setContinuation(uint32_t parent, uint32_t child);
+
+    size_t size() const;
+    size_t getMemoryUsage() const;
+
+private:
+    static const size_t MaxNotationLength = 7;
+
+    struct Node {
+        uint64_t hash;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t nextSibling;
+        uint32_t continuation;
+        uint32_t checkpoint;
+        uint16_t ply;
+        uint8_t origin;
+        uint8_t destination;
+        uint8_t type;
+        uint8_t state;
+        char notation[MaxNotationLength + 1];
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<Game> _checkpoints;
+};
+
+}
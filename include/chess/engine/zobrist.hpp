@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace chess {
+
+// Random keys for Game::getHash, generated at compile time so every build
+// and every thread hashes a position to the same value.
+namespace zobrist {
+
+constexpr uint64_t splitMix(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+struct Keys {
+    uint64_t pieces[2][6][64];
+    uint64_t castling[4];
+    uint64_t enPassant[8];
+    uint64_t blackToMove;
+};
+
+constexpr Keys generateKeys() {
+    Keys keys{};
+    uint64_t state = 0x4368657373517421ULL;
+    for(auto& color : keys.pieces) {
+        for(auto& type : color) {
+            for(auto& key : type) {
+                key = splitMix(state);
+            }
+        }
+    }
+    for(auto& key : keys.castling) {
+        key = splitMix(state);
+    }
+    for(auto& key : keys.enPassant) {
+        key = splitMix(state);
+    }
+    keys.blackToMove = splitMix(state);
+    return keys;
+}
+
+inline constexpr Keys keys = generateKeys();
+
+static_assert(keys.pieces[0][0][0] != keys.pieces[0][0][1], "distinct keys");
+
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef ENGINE_WORKER_HPP
+#define ENGINE_WORKER_HPP
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "engine/engine.hpp"
+
+// Everything the window needs to draw one position. Snapshots are built on
+// the engine thread and never modified after they are sent, so the GUI can
+// hold on to one without locking.
+struct EngineSnapshot {
+    quint64 generation;
+    quint64 positionVersion;
+    chess::Game game;
+    chess::GameState state;
+    std::pair<short, short> checkPosition;
+    std::pair<short, short> selectedPosition;
+    std::vector<std::pair<short, short>> possibleMoves;
+    std::vector<chess::Piece> materialImbalance;
+    size_t positionIndex;
+    bool moved;
+
+    // Move history changes since the previous snapshot: when historyReset is
+    // set the table is rebuilt, otherwise changedMoves replaces every ply from
+    // firstChangedPly on.
+    bool historyReset;
+    chess::PieceColor firstTurn;
+    short startingMoveIndex;
+    size_t firstChangedPly;
+    std::vector<chess::MoveInfo> changedMoves;
+};
+
+using EngineSnapshotPtr = std::shared_ptr<const EngineSnapshot>;
+
+Q_DECLARE_METATYPE(EngineSnapshotPtr)
+
+// Owns the Engine and lives on its own thread. Every request carries the
+// generation the window assigned to it; once a newer request is made the
+// older ones still change the engine's state but no longer build snapshots.
+class EngineWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit EngineWorker(QObject* parent = nullptr);
+
+    void cancelBefore(quint64 generation);
+
+public slots:
+    void refresh(quint64 generation);
+    void click(quint64 generation, short x, short y);
+    void selectPosition(quint64 generation, size_t position);
+    void previousPosition(quint64 generation);
+    void nextPosition(quint64 generation);
+    void setBoard(quint64 generation, const QString& fen);
+
+signals:
+    void snapshotReady(EngineSnapshotPtr snapshot);
+    void boardRejected(quint64 generation, const QString& fen);
+
+protected:
+    bool isStale(quint64 generation) const;
+    void markHistoryChanged(size_t firstChangedPly);
+    void publish(quint64 generation, bool moved = false);
+
+private:
+    chess::Engine _engine;
+    std::atomic<quint64> _latestGeneration;
+    quint64 _positionVersion;
+    bool _historyReset;
+    size_t _firstChangedPly;
+};
+
+#endif // ENGINE_WORKER_HPP
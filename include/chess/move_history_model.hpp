@@ -0,0 +1,40 @@
+#ifndef MOVE_HISTORY_MODEL_HPP
+#define MOVE_HISTORY_MODEL_HPP
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <vector>
+#include "engine/move_info.hpp"
+
+// Two column (white, black) view of the game's moves. The model keeps its
+// own copy of the notation and is only sent the plies from the first one
+// that changed, so appending a move touches one row instead of rebuilding
+// the table.
+class MoveHistoryModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit MoveHistoryModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    void reset(chess::PieceColor firstTurn, short startingMoveIndex);
+    void update(size_t firstChangedPly, const std::vector<chess::MoveInfo>& moves);
+
+    QModelIndex getIndex(size_t ply) const;
+    size_t getPly(const QModelIndex& index) const;
+
+protected:
+    int getRowCount(size_t noPlies) const;
+
+private:
+    std::vector<QString> _moves;
+    int _offset;
+    short _startingMoveIndex;
+};
+
+#endif // MOVE_HISTORY_MODEL_HPP
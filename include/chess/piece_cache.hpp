@@ -0,0 +1,36 @@
+#ifndef PIECE_CACHE_HPP
+#define PIECE_CACHE_HPP
+
+#include <QPixmap>
+#include <QString>
+#include <QSvgRenderer>
+#include <memory>
+#include <vector>
+#include "engine/piece.hpp"
+
+class PieceCache {
+public:
+    static const int MaxSizes = 4;
+
+    PieceCache();
+    PieceCache(const PieceCache& other) = delete;
+
+    PieceCache& operator=(const PieceCache& other) = delete;
+
+    void load(const QString& directory);
+    QPixmap getPixmap(chess::Piece piece, int size, qreal devicePixelRatio = 1.0);
+
+protected:
+    struct Entry {
+        int size;
+        QPixmap pixmaps[2][6];
+    };
+
+    void render(Entry& entry, size_t colorNo, size_t typeNo, qreal devicePixelRatio);
+
+private:
+    std::unique_ptr<QSvgRenderer> _renderers[2][6];
+    std::vector<Entry> _entries;
+};
+
+#endif // PIECE_CACHE_HPP
@@ -0,0 +1,97 @@
+#include "../include/chess/analyser.hpp"
+
+using namespace chess;
+
+AnalysisProgress::AnalysisProgress()
+    : id(0), turn(PieceColor::White), result(), milliseconds(0) {}
+
+Analyser::Analyser(QObject* parent)
+    : QObject(parent),
+      _mutex(),
+      _condition(),
+      _pending(),
+      _id(0),
+      _quit(false),
+      _stop(false),
+      _progress(),
+      _updated(false),
+      _thread(&Analyser::run, this) {}
+
+Analyser::~Analyser() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+        _stop = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+}
+
+quint64 Analyser::start(const Game& game) {
+    quint64 id;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.reset(new Game(game));
+        id = ++_id;
+        _updated = false;
+        _stop = true;
+    }
+    _condition.notify_one();
+    return id;
+}
+
+void Analyser::stop() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.reset();
+    _id++;
+    _updated = false;
+    _stop = true;
+}
+
+bool Analyser::takeProgress(AnalysisProgress& progress) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!_updated) {
+        return false;
+    }
+    progress = _progress;
+    _updated = false;
+    return true;
+}
+
+void Analyser::run() {
+    while(true) {
+        std::unique_ptr<Game> game;
+        quint64 id;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]{ return _quit || _pending; });
+            if(_quit) {
+                return;
+            }
+            game = std::move(_pending);
+            id = _id;
+            _stop = false;
+        }
+
+        SearchLimits limits;
+        limits.depth = Search::MaxDepth;
+        limits.stop = &_stop;
+        auto start = std::chrono::steady_clock::now();
+        Search search(*game);
+        search.run(limits, [&](const SearchResult& result) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(id != _id) {
+                    return;
+                }
+                _progress.id = id;
+                _progress.turn = game->getTurn();
+                _progress.result = result;
+                _progress.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+                _updated = true;
+            }
+            emit progressed();
+        });
+    }
+}
@@ -0,0 +1,58 @@
+#include "../include/chess/engine/arena.hpp"
+#include <cstdint>
+
+using namespace chess;
+
+Arena::Scope::Scope(Arena& arena)
+    : _arena(arena), _chunk(arena._current), _offset(arena._offset) {}
+
+Arena::Scope::~Scope() {
+    _arena._current = _chunk;
+    _arena._offset = _offset;
+}
+
+Arena::Arena(size_t chunkSize)
+    : _chunks(), _chunkSize(chunkSize), _current(0), _offset(0) {}
+
+void Arena::reset() {
+    _current = 0;
+    _offset = 0;
+}
+
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for(const auto& chunk : _chunks) {
+        capacity += chunk.size;
+    }
+    return capacity;
+}
+
+Arena& Arena::local() {
+    thread_local Arena arena;
+    return arena;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    while(true) {
+        if(_current == _chunks.size()) {
+            size_t size = bytes + alignment > _chunkSize ? bytes + alignment : _chunkSize;
+            _chunks.push_back(Chunk{std::unique_ptr<char[]>(new char[size]), size});
+        }
+        Chunk& chunk = _chunks[_current];
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+        uintptr_t aligned = (base + _offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        size_t offset = static_cast<size_t>(aligned - base);
+        if(offset + bytes <= chunk.size) {
+            _offset = offset + bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+        _current++;
+        _offset = 0;
+    }
+}
+
+void Arena::do_deallocate(void*, size_t, size_t) {}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -1,4 +1,5 @@
 #include "../include/chess/engine/board.hpp"
+#include "../include/chess/engine/stats.hpp"
 
 using namespace chess;
 
@@ -9,27 +10,68 @@ Square& BoardHelper::operator[](short y) {
 	return _board[std::make_pair(_x, y)];
 }
 
+ConstBoardHelper::ConstBoardHelper(const Board& board, short x)
+	: _board(board), _x(x) {}
+
+const Square& ConstBoardHelper::operator[](short y) const {
+	return _board[std::make_pair(_x, y)];
+}
+
 Board::Board() {
-	for(short y = 0; y < 8; y++) {
-		for(short x = 0; x < 8; x++) {
-			_board.insert(std::make_pair(std::make_pair(x, y), Square(x, y)));
+	for(short x = 0; x < 8; x++) {
+		for(short y = 0; y < 8; y++) {
+			_board[x * 8 + y] = Square(x, y);
 		}
 	}
 }
 
+#ifdef CHESS_STATS
+Board::Board(const Board& other)
+	: _board() {
+	CHESS_STATS_TIME(BoardCopies);
+	_board = other._board;
+}
+
+Board& Board::operator=(const Board& other) {
+	CHESS_STATS_TIME(BoardCopies);
+	_board = other._board;
+	return *this;
+}
+#endif
+
 BoardHelper Board::operator[](short x) {
 	return BoardHelper(*this, x);
 }
 
+ConstBoardHelper Board::operator[](short x) const {
+	return ConstBoardHelper(*this, x);
+}
+
 Square& Board::operator[](const std::string& position) {
 	return operator[](Square::convertPosition(position));
 }
 
+const Square& Board::operator[](const std::string& position) const {
+	return operator[](Square::convertPosition(position));
+}
+
 Square& Board::operator[](const std::pair<short, short>& position) {
-	return _board.find(position)->second;
+	return _board[position.first * 8 + position.second];
+}
+
+const Square& Board::operator[](const std::pair<short, short>& position) const {
+	return _board[position.first * 8 + position.second];
+}
+
+Square& Board::getSquare(short index) {
+	return _board[index];
+}
+
+const Square& Board::getSquare(short index) const {
+	return _board[index];
 }
 
-bool Board::operator==(Board& other) {
+bool Board::operator==(const Board& other) const {
     for(short x = 0; x < 8; x++) {
         for(short y = 0; y < 8; y++) {
             auto position = std::make_pair(x, y);
@@ -41,7 +83,7 @@ bool Board::operator==(Board& other) {
     return true;
 }
 
-bool Board::operator!=(Board& other) {
+bool Board::operator!=(const Board& other) const {
     return !(*this == other);
 }
 
@@ -0,0 +1,175 @@
+#include "../include/chess/board_widget.hpp"
+#include "../include/chess/piece_cache.hpp"
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+
+using namespace chess;
+
+namespace {
+
+const int borderWidth = 5;
+const QColor selectedColor("#FFFF99");
+const QColor moveColor("#66CC66");
+const QColor checkColor("#CC3333");
+
+}
+
+BoardWidget::BoardWidget(PieceCache& pieceCache, QWidget* parent)
+    : QWidget(parent), _pieceCache(pieceCache), _lightColor(232, 235, 239), _darkColor(125, 135, 150),
+      _whiteIsFront(true), _hoveredX(-1), _hoveredY(-1) {
+    for(short x = 0; x < 8; x++) {
+        for(short y = 0; y < 8; y++) {
+            _highlights[x][y] = Highlight::None;
+        }
+    }
+    setMouseTracking(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    QSizePolicy policy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    policy.setHeightForWidth(true);
+    setSizePolicy(policy);
+}
+
+void BoardWidget::setPiece(short x, short y, Piece piece) {
+    if(_pieces[x][y] != piece) {
+        _pieces[x][y] = piece;
+        update(getSquareRect(x, y));
+    }
+}
+
+void BoardWidget::setHighlight(short x, short y, Highlight highlight) {
+    if(_highlights[x][y] != highlight) {
+        _highlights[x][y] = highlight;
+        update(getSquareRect(x, y));
+    }
+}
+
+void BoardWidget::clearHighlights() {
+    for(short x = 0; x < 8; x++) {
+        for(short y = 0; y < 8; y++) {
+            setHighlight(x, y, Highlight::None);
+        }
+    }
+}
+
+void BoardWidget::setColors(const QColor& lightColor, const QColor& darkColor) {
+    _lightColor = lightColor;
+    _darkColor = darkColor;
+    update();
+}
+
+void BoardWidget::setWhiteIsFront(bool whiteIsFront) {
+    _whiteIsFront = whiteIsFront;
+    update();
+}
+
+QSize BoardWidget::sizeHint() const {
+    return QSize(480, 480);
+}
+
+bool BoardWidget::hasHeightForWidth() const {
+    return true;
+}
+
+int BoardWidget::heightForWidth(int width) const {
+    return width;
+}
+
+void BoardWidget::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().window());
+    int squareSize = getSquareSize();
+    for(short x = 0; x < 8; x++) {
+        for(short y = 0; y < 8; y++) {
+            QRect rect = getSquareRect(x, y);
+            if(!event->rect().intersects(rect)) {
+                continue;
+            }
+            Highlight highlight = _highlights[x][y];
+            bool hovered = highlight == Highlight::Move && x == _hoveredX && y == _hoveredY;
+            painter.fillRect(rect, hovered ? moveColor : (x + y) % 2 ? _lightColor : _darkColor);
+            if(highlight != Highlight::None) {
+                QColor color = highlight == Highlight::Selected ? selectedColor
+                             : highlight == Highlight::Check ? checkColor : moveColor;
+                painter.fillRect(rect.x(), rect.y(), rect.width(), borderWidth, color);
+                painter.fillRect(rect.x(), rect.bottom() - borderWidth + 1, rect.width(), borderWidth, color);
+                painter.fillRect(rect.x(), rect.y(), borderWidth, rect.height(), color);
+                painter.fillRect(rect.right() - borderWidth + 1, rect.y(), borderWidth, rect.height(), color);
+            }
+            QPixmap pixmap = _pieceCache.getPixmap(_pieces[x][y], squareSize, devicePixelRatioF());
+            if(!pixmap.isNull()) {
+                painter.drawPixmap(rect.topLeft(), pixmap);
+            }
+        }
+    }
+}
+
+void BoardWidget::mousePressEvent(QMouseEvent* event) {
+    short x, y;
+    if(event->button() == Qt::LeftButton && getSquareAt(event->pos(), x, y)) {
+        emit clicked(x, y);
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void BoardWidget::mouseMoveEvent(QMouseEvent* event) {
+    short x, y;
+    if(getSquareAt(event->pos(), x, y)) {
+        setHovered(x, y);
+    } else {
+        setHovered(-1, -1);
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
+void BoardWidget::leaveEvent(QEvent* event) {
+    setHovered(-1, -1);
+    QWidget::leaveEvent(event);
+}
+
+int BoardWidget::getSquareSize() const {
+    return qMin(width(), height()) / 8;
+}
+
+QRect BoardWidget::getSquareRect(short x, short y) const {
+    int squareSize = getSquareSize();
+    int left = (width() - 8 * squareSize) / 2;
+    int top = (height() - 8 * squareSize) / 2;
+    short column = _whiteIsFront ? x : 7 - x;
+    short row = _whiteIsFront ? 7 - y : y;
+    return QRect(left + column * squareSize, top + row * squareSize, squareSize, squareSize);
+}
+
+bool BoardWidget::getSquareAt(const QPoint& point, short& x, short& y) const {
+    int squareSize = getSquareSize();
+    if(squareSize == 0) {
+        return false;
+    }
+    int left = (width() - 8 * squareSize) / 2;
+    int top = (height() - 8 * squareSize) / 2;
+    if(point.x() < left || point.y() < top) {
+        return false;
+    }
+    int column = (point.x() - left) / squareSize;
+    int row = (point.y() - top) / squareSize;
+    if(column > 7 || row > 7) {
+        return false;
+    }
+    x = static_cast<short>(_whiteIsFront ? column : 7 - column);
+    y = static_cast<short>(_whiteIsFront ? 7 - row : row);
+    return true;
+}
+
+void BoardWidget::setHovered(short x, short y) {
+    if(x == _hoveredX && y == _hoveredY) {
+        return;
+    }
+    if(_hoveredX != -1 && _highlights[_hoveredX][_hoveredY] == Highlight::Move) {
+        update(getSquareRect(_hoveredX, _hoveredY));
+    }
+    _hoveredX = x;
+    _hoveredY = y;
+    if(_hoveredX != -1 && _highlights[_hoveredX][_hoveredY] == Highlight::Move) {
+        update(getSquareRect(_hoveredX, _hoveredY));
+    }
+}
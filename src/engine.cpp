@@ -1,65 +1,95 @@
 #include "../include/chess/engine/engine.hpp"
+#include "../include/chess/engine/arena.hpp"
 #include <algorithm>
 
 using namespace chess;
 
 Engine::Engine()
-    : _positionHistory(), _moveHistory(), _currentGameIndex(0),
-      _currentGame(), _gameRules(_currentGame) {
-    _positionHistory.push_back(_currentGame);
+    : _variationTree(), _line(), _currentGameIndex(0),
+      _currentGame(),
+      _legalMoveCache(), _legalMoves(), _selectedSquare(nullptr) {
+    updatePosition();
     setGameState();
+    _variationTree.reset(_currentGame);
+    _line.push_back(VariationTree::Root);
 }
 
 bool Engine::selectPiece(const std::pair<short, short>& piecePosition) {
-    if(_currentGame.getGameState() == GameState::Playing) {
-        return _gameRules.selectSquare(piecePosition);
-    } else {
+    if(_currentGame.getGameState() != GameState::Playing || !Board::positionExists(piecePosition)) {
         return false;
     }
+    const Square& square = _currentGame.getBoard()[piecePosition];
+    if(square.piece.type != PieceType::None && square.piece.color == _currentGame.getTurn()) {
+        _selectedSquare = &square;
+        return true;
+    }
+    _selectedSquare = nullptr;
+    return false;
 }
 
-Square* Engine::getSelectedSquare() {
-    return _gameRules.getSelectedSquare();
+const Square* Engine::getSelectedSquare() {
+    return _selectedSquare;
 }
 
 void Engine::deselectPiece() {
-    _gameRules.deselectSquare();
+    _selectedSquare = nullptr;
 }
 
 bool Engine::move(const std::pair<short, short>& destination) {
-    if(_currentGame.getGameState() != GameState::Playing) {
+    if(_currentGame.getGameState() != GameState::Playing || !_selectedSquare) {
         return false;
     }
-    auto moveType = _gameRules.getMoveType(destination);
-    if(moveType != MoveType::None) {
-        cutFutureMoves();
-        MoveInfo info = createMoveInfo(destination, moveType, _currentGame.getTurn());
-        _moveHistory.push_back(info);
-        auto origin = _gameRules.getSelectedSquare()->getPosition();
-        _currentGame.move(origin, destination, moveType);
-        setGameState();
-        _gameRules.updatePosition();
-        _positionHistory.push_back(_currentGame);
+    Arena::Scope scope(Arena::local());
+    short origin = _selectedSquare->getX() * 8 + _selectedSquare->getY();
+    auto move = std::find_if(_legalMoves->begin(origin), _legalMoves->end(origin), [&](const Move& move) {
+        return move.destination == destination;
+    });
+    if(move != _legalMoves->end(origin)) {
+        Move played = *move;
+        uint32_t parent = _line[_currentGameIndex];
+        uint32_t node = _variationTree.findChild(parent, played);
+        if(node != VariationTree::NoNode) {
+            _variationTree.applyMove(node, _currentGame);
+            updatePosition();
+        } else {
+            _currentGame.move(played.origin, played.destination, played.type);
+            updatePosition();
+            setGameState();
+            node = _variationTree.addChild(parent, played, _currentGame);
+        }
+        _variationTree.setContinuation(parent, node);
+        followContinuations();
         _currentGameIndex++;
 		return true;
 	}
 	return false;
 }
 
-void Engine::cutFutureMoves() {
-    auto replacedPosition = _positionHistory.begin();
-    auto replacedMove = _moveHistory.begin();
-    std::advance(replacedPosition, _currentGameIndex + 1);
-    std::advance(replacedMove, _currentGameIndex);
-    _positionHistory.erase(replacedPosition, _positionHistory.end());
-    _moveHistory.erase(replacedMove, _moveHistory.end());
+void Engine::updatePosition() {
+    _selectedSquare = nullptr;
+    uint64_t hash = _currentGame.getHash();
+    _legalMoves = _legalMoveCache.find(hash);
+    if(!_legalMoves) {
+        Arena::Scope scope(Arena::local());
+        auto moves = rules::legalMoves(_currentGame, &Arena::local());
+        _legalMoves = _legalMoveCache.insert(hash, std::make_shared<LegalMoves>(moves.data(), moves.data() + moves.size()));
+    }
+}
+
+void Engine::followContinuations() {
+    _line.erase(_line.begin() + _currentGameIndex + 1, _line.end());
+    uint32_t node = _variationTree.getContinuation(_line.back());
+    while(node != VariationTree::NoNode) {
+        _line.push_back(node);
+        node = _variationTree.getContinuation(node);
+    }
 }
 
 bool Engine::selectPosition(size_t position) {
-    if(position < _positionHistory.size()) {
+    if(position < _line.size()) {
         _currentGameIndex = position;
-        _currentGame = _positionHistory[_currentGameIndex];
-        _gameRules.updatePosition();
+        _currentGame = _variationTree.getPosition(_line[_currentGameIndex]);
+        updatePosition();
         return true;
     } else {
         return false;
@@ -68,119 +98,94 @@ bool Engine::selectPosition(size_t position) {
 
 size_t Engine::previousPosition() {
     if(_currentGameIndex != 0) {
-        _currentGame = _positionHistory[--_currentGameIndex];
-        _gameRules.updatePosition();
+        _currentGame = _variationTree.getPosition(_line[--_currentGameIndex]);
+        updatePosition();
         return _currentGameIndex;
     }
     return -1;
 }
 
 size_t Engine::nextPosition() {
-    if(_currentGameIndex < _positionHistory.size() - 1) {
-        _currentGame = _positionHistory[++_currentGameIndex];
-        _gameRules.updatePosition();
+    if(_currentGameIndex < _line.size() - 1) {
+        _variationTree.applyMove(_line[++_currentGameIndex], _currentGame);
+        updatePosition();
         return _currentGameIndex;
     }
     return -1;
 }
 
+std::vector<MoveInfo> Engine::getVariations() {
+    std::vector<MoveInfo> variations;
+    for(uint32_t child : _variationTree.getChildren(_line[_currentGameIndex])) {
+        if(!_variationTree.hasNotation(child)) {
+            _variationTree.setNotation(child, getNotation(_currentGame, _variationTree.getMove(child)));
+        }
+        variations.push_back(MoveInfo(_currentGame.getTurn(), _variationTree.getNotation(child)));
+    }
+    return variations;
+}
+
+bool Engine::selectVariation(size_t variation) {
+    auto children = _variationTree.getChildren(_line[_currentGameIndex]);
+    if(variation >= children.size()) {
+        return false;
+    }
+    _variationTree.setContinuation(_line[_currentGameIndex], children[variation]);
+    followContinuations();
+    nextPosition();
+    return true;
+}
+
 void Engine::setBoard(const std::string& fen) {
     Game game(fen); // if fen is invalid it will throw invalid_argument exception
     _currentGame = game;
-    setGameState();
     _currentGameIndex = 0;
-    _positionHistory.clear();
-    _positionHistory.push_back(_currentGame);
-    _moveHistory.clear();
-    _gameRules.updatePosition();
+    _line.clear();
+    updatePosition();
+    setGameState();
+    _variationTree.reset(_currentGame);
+    _line.push_back(VariationTree::Root);
 }
 
-Board Engine::getBoard() {
+const Board& Engine::getBoard() {
 	return _currentGame.getBoard();
 }
 
+const Game& Engine::getGame() const {
+    return _currentGame;
+}
+
 GameState Engine::getGameState() {
     return _currentGame.getGameState();
 }
 
+PieceColor Engine::getTurn() {
+    return _currentGame.getTurn();
+}
+
 void Engine::setGameState() {
-    auto board = _currentGame.getBoard();
+    CHESS_STATS_TIME(SetGameState);
+    uint64_t hash = _currentGame.getHash();
     short noRepetitions = 1;
-    for(short i = 0; i <= _currentGameIndex; i++) {
-        if(_positionHistory[i].getBoard() == board) {
+    for(size_t i = 0; i < _line.size() && i <= _currentGameIndex; i++) {
+        if(_variationTree.getHash(_line[i]) == hash) {
             noRepetitions++;
         }
     }
-    if(noRepetitions >= 3) {
-        _currentGame.setGameState(GameState::Draw);
-        return;
-    }
-    GameRules gameRules(_currentGame);
-    std::vector<Square> pieces;
-    bool canMove = false;
-	for(short x = 0; x < 8; x++) {
-		for(short y = 0; y < 8; y++) {
-            auto square = board[x][y];
-            if(square.piece.type != PieceType::None && square.piece.type != PieceType::King) {
-                pieces.push_back(square);
-            }
-            if(gameRules.selectSquare(std::make_pair(x, y))) {
-                if(!gameRules.getPossibleMoves().empty()) {
-                    canMove = true;
-				}
-			}
-		}
-    }
-
-    GameState state;
-    if(canMove) {
-        if(_currentGame.getNoHalfMoves() >= 100) {
-            state =  GameState::Draw;
-        } else {
-            if(pieces.empty()) {
-                state = GameState::Draw;
-            } else if(pieces.size() == 1) {
-                PieceType type = pieces.front().piece.type;
-                if(type == PieceType::Bishop || type == PieceType::Knight) {
-                    state = GameState::Draw;
-                } else {
-                    state = GameState::Playing;
-                }
-            } else if(pieces.size() == 2) {
-                if(pieces[0].piece.type == PieceType::Bishop && pieces[1].piece.type == PieceType::Bishop) {
-                    if((pieces[0].getX() + pieces[0].getY()) % 2 == (pieces[1].getX() + pieces[1].getY()) % 2) {
-                        state = GameState::Draw;
-                    } else {
-                        state = GameState::Playing;
-                    }
-                } else {
-                    state = GameState::Playing;
-                }
-            } else {
-                state = GameState::Playing;
-            }
-        }
-    } else {
-        if(_gameRules.isCheck(_currentGame.getTurn())) {
-            if(_currentGame.getTurn() == PieceColor::White) {
-                state = GameState::BlackWin;
-            } else {
-                state = GameState::WhiteWin;
-            }
-        } else {
-            state = GameState::Draw;
-        }
-    }
-    _currentGame.setGameState(state);
+    _currentGame.setGameState(rules::gameState(_currentGame, noRepetitions));
 }
 
 short Engine::getStartingMoveIndex() {
-    return _positionHistory.front().getNoMoves();
+    return _variationTree.getRootPosition().getNoMoves();
+}
+
+size_t Engine::getPositionIndex() const {
+    return _currentGameIndex;
 }
 
 std::pair<short, short> Engine::getCheckPosition() {
     auto checkedKingColor = _currentGame.getTurn();
-    if(_gameRules.isCheck(checkedKingColor)) {
+    if(rules::isCheck(_currentGame, checkedKingColor)) {
         if(checkedKingColor == PieceColor::White) {
             return _currentGame.getWhiteKingSquare()->getPosition();
         } else {
@@ -191,88 +196,139 @@ std::pair<short, short> Engine::getCheckPosition() {
 }
 
 std::unordered_set<std::pair<short, short>, PairHash> Engine::getPossibleMoves() {
-	return _gameRules.getPossibleMoves();
+    std::unordered_set<std::pair<short, short>, PairHash> moves;
+    if(_selectedSquare) {
+        short origin = _selectedSquare->getX() * 8 + _selectedSquare->getY();
+        for(const Move* move = _legalMoves->begin(origin); move != _legalMoves->end(origin); move++) {
+            moves.insert(move->destination);
+        }
+    }
+    return moves;
 }
 
-std::vector<MoveInfo> Engine::getMoveHistory() {
-    return _moveHistory;
+std::vector<Move> Engine::getLegalMoves() {
+    return _legalMoves->getMoves();
 }
 
-std::vector<Piece> Engine::getMaterialImbalance() {
-    std::vector<Piece> whitePieces;
-    std::vector<Piece> blackPieces;
-    auto board = _currentGame.getBoard();
-    for(short x = 0; x < 8; x++) {
-        for(short y = 0; y < 8; y++) {
-            Piece piece = board[x][y].piece;
-            if(piece.type != PieceType::None) {
-                if(piece.color == PieceColor::White) {
-                    whitePieces.push_back(piece);
-                } else {
-                    blackPieces.push_back(piece);
-                }
+std::vector<MoveInfo> Engine::getMoveHistory(size_t firstPly) {
+    std::vector<MoveInfo> history;
+    size_t noPlies = getHistorySize();
+    if(firstPly >= noPlies) {
+        return history;
+    }
+    history.reserve(noPlies - firstPly);
+    PieceColor turn = _variationTree.getRootPosition().getTurn();
+    if(firstPly % 2 == 1) {
+        turn = turn == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    }
+    std::unique_ptr<Game> game;
+    for(size_t ply = firstPly; ply < noPlies; ply++) {
+        uint32_t node = _line[ply + 1];
+        if(!_variationTree.hasNotation(node)) {
+            if(!game) {
+                game.reset(new Game(_variationTree.getPosition(_line[ply])));
             }
+            _variationTree.setNotation(node, getNotation(*game, _variationTree.getMove(node)));
+        }
+        if(game) {
+            _variationTree.applyMove(node, *game);
         }
+        history.push_back(MoveInfo(turn, _variationTree.getNotation(node)));
+        turn = turn == PieceColor::White ? PieceColor::Black : PieceColor::White;
     }
-    std::sort(
-                whitePieces.begin(), whitePieces.end(),
-                [](auto a, auto b){return static_cast<int>(a.type) < static_cast<int>(b.type);}
-    );
-    std::sort(
-                blackPieces.begin(), blackPieces.end(),
-                [](auto a, auto b){return static_cast<int>(a.type) < static_cast<int>(b.type);}
-    );
+    return history;
+}
+
+size_t Engine::getHistorySize() const {
+    return _line.size() - 1;
+}
+
+const Game& Engine::getStartingPosition() const {
+    return _variationTree.getRootPosition();
+}
+
+std::vector<Move> Engine::getMoves() const {
+    std::vector<Move> moves;
+    moves.reserve(getHistorySize());
+    for(size_t ply = 1; ply < _line.size(); ply++) {
+        moves.push_back(_variationTree.getMove(_line[ply]));
+    }
+    return moves;
+}
+
+std::vector<Piece> Engine::getMaterialImbalance() {
     std::vector<Piece> imbalance;
-    std::set_difference(
-                whitePieces.begin(), whitePieces.end(),
-                blackPieces.begin(), blackPieces.end(),
-                std::back_inserter(imbalance),
-                [](auto a, auto b){return static_cast<int>(a.type) < static_cast<int>(b.type);}
-    );
-    std::set_difference(
-                blackPieces.begin(), blackPieces.end(),
-                whitePieces.begin(), whitePieces.end(),
-                std::back_inserter(imbalance),
-                [](auto a, auto b){return static_cast<int>(a.type) < static_cast<int>(b.type);}
-    );
+    for(PieceColor color : {PieceColor::White, PieceColor::Black}) {
+        PieceColor enemy = color == PieceColor::White ? PieceColor::Black : PieceColor::White;
+        for(short type = static_cast<short>(PieceType::Pawn); type <= static_cast<short>(PieceType::King); type++) {
+            Piece piece;
+            piece.type = static_cast<PieceType>(type);
+            piece.color = color;
+            short surplus = _currentGame.getPieceCount(color, piece.type) - _currentGame.getPieceCount(enemy, piece.type);
+            imbalance.insert(imbalance.end(), std::max<short>(surplus, 0), piece);
+        }
+    }
     return imbalance;
 }
 
-MoveInfo Engine::createMoveInfo(const std::pair<short, short>& destination, MoveType moveType, PieceColor turn) {
-    if(moveType == MoveType::Castle) {
-        if(destination.first == 2) {
-            return MoveInfo(turn, "O-O-O");
+Stats Engine::stats() {
+    return Stats::snapshot();
+}
+
+void Engine::resetStats() {
+    Stats::reset();
+}
+
+SearchResult Engine::analyse(const SearchLimits& limits) {
+    Search search(_currentGame);
+    return search.run(limits);
+}
+
+size_t Engine::getMemoryUsage() const {
+    return sizeof(Engine)
+            + _variationTree.getMemoryUsage()
+            + _line.capacity() * sizeof(uint32_t)
+            + _legalMoveCache.getMemoryUsage();
+}
+
+std::string Engine::getNotation(const Game& game, const Move& move) {
+    if(move.type == MoveType::Castle) {
+        if(move.destination.first == 2) {
+            return "O-O-O";
         } else {
-            return MoveInfo(turn, "O-O");
+            return "O-O";
         }
     }
-    auto selectedSquare = *_gameRules.getSelectedSquare();
-    auto board = _currentGame.getBoard();
-    Game game(_currentGame);
-    GameRules gameRules(game);
-    bool addFile = false;
-    bool addRank = false;
-    for(short x = 0; x < 8; x++) {
-        for(short y = 0; y < 8; y++) {
-            auto pair = std::make_pair(x, y);
-            if(pair == selectedSquare.getPosition()) {
-                continue;
+    Arena::Scope scope(Arena::local());
+    const auto& board = game.getBoard();
+    const auto& selectedSquare = board[move.origin];
+    std::pmr::vector<Move> legalMoves(&Arena::local());
+    auto cached = _legalMoveCache.find(game.getHash());
+    if(cached) {
+        legalMoves.assign(cached->getMoves().begin(), cached->getMoves().end());
+    } else {
+        legalMoves = rules::legalMoves(game, &Arena::local());
+    }
+    bool ambiguous = false;
+    bool sameFile = false;
+    bool sameRank = false;
+    for(const auto& other : legalMoves) {
+        if(other.destination != move.destination || other.origin == move.origin) {
+            continue;
+        }
+        if(board[other.origin].piece.type == selectedSquare.piece.type && selectedSquare.piece.type != PieceType::Pawn) {
+            ambiguous = true;
+            if(other.origin.first == selectedSquare.getX()) {
+                sameFile = true;
             }
-            if(board[x][y].piece.type == selectedSquare.piece.type) {
-                if(gameRules.selectSquare(std::make_pair(x, y))) {
-                    auto moves = gameRules.getPossibleMoves();
-                    if(moves.find(destination) != moves.end()) {
-                        if(x == selectedSquare.getX()) {
-                            addFile = true;
-                        }
-                        if(y == selectedSquare.getY()) {
-                            addRank = true;
-                        }
-                    }
-                }
+            if(other.origin.second == selectedSquare.getY()) {
+                sameRank = true;
             }
         }
     }
+    // The file tells the pieces apart unless one of them shares it.
+    bool addFile = ambiguous && (!sameFile || sameRank);
+    bool addRank = ambiguous && sameFile;
     std::string algebraicNotation;
     switch (selectedSquare.piece.type) {
     case PieceType::King:
@@ -294,40 +350,30 @@ MoveInfo Engine::createMoveInfo(const std::pair<short, short>& destination, Move
         break;
     }
     if(addFile) {
-        algebraicNotation += Square::getFile(selectedSquare.getPosition());
+        algebraicNotation += Square::getFile(move.origin);
     }
     if(addRank) {
-        algebraicNotation += Square::getRank(selectedSquare.getPosition());
+        algebraicNotation += Square::getRank(move.origin);
     }
-    if(board[destination].piece.type != PieceType::None || moveType == MoveType::EnPassantCapture) {
+    if(board[move.destination].piece.type != PieceType::None || move.type == MoveType::EnPassantCapture) {
         if(selectedSquare.piece.type == PieceType::Pawn) {
-            algebraicNotation += Square::getFile(selectedSquare.getPosition());
+            algebraicNotation += Square::getFile(move.origin);
         }
         algebraicNotation += "x";
     }
-    algebraicNotation += Square::convertPosition(destination);
-    if(moveType == MoveType::Promotion) {
+    algebraicNotation += Square::convertPosition(move.destination);
+    if(move.type == MoveType::Promotion) {
         algebraicNotation += "=Q";
     }
-    game.move(selectedSquare.getPosition(), destination, moveType);
-    gameRules.updatePosition();
-    if(gameRules.isCheck((turn == PieceColor::White ? PieceColor::Black : PieceColor::White))) {
-        bool canMove = false;
-        for(short x = 0; x < 8; x++) {
-            for(short y = 0; y < 8; y++) {
-                if(gameRules.selectSquare(std::make_pair(x, y))) {
-                    if(!gameRules.getPossibleMoves().empty()) {
-                        canMove = true;
-                    }
-                }
-            }
-        }
-        if(canMove) {
+    Game after(game);
+    after.move(move.origin, move.destination, move.type);
+    if(rules::isCheck(after, after.getTurn())) {
+        if(rules::hasLegalMoves(after)) {
             algebraicNotation += "+";
         } else {
             algebraicNotation += "#";
         }
 
     }
-    return MoveInfo(turn, algebraicNotation);
+    return algebraicNotation;
 }
@@ -0,0 +1,121 @@
+#include "../include/chess/engine_worker.hpp"
+#include <stdexcept>
+
+using namespace chess;
+
+EngineWorker::EngineWorker(QObject* parent)
+    : QObject(parent),
+      _engine(),
+      _latestGeneration(0),
+      _positionVersion(0),
+      _historyReset(true),
+      _firstChangedPly(0) {}
+
+void EngineWorker::cancelBefore(quint64 generation) {
+    quint64 latest = _latestGeneration.load(std::memory_order_relaxed);
+    while(latest < generation && !_latestGeneration.compare_exchange_weak(latest, generation, std::memory_order_relaxed)) {}
+}
+
+void EngineWorker::refresh(quint64 generation) {
+    publish(generation);
+}
+
+void EngineWorker::click(quint64 generation, short x, short y) {
+    auto position = std::make_pair(x, y);
+    auto selectedSquare = _engine.getSelectedSquare();
+    if(selectedSquare) {
+        if(selectedSquare->getPosition() == position) {
+            _engine.deselectPiece();
+            publish(generation);
+            return;
+        }
+        size_t ply = _engine.getPositionIndex();
+        if(_engine.move(position)) {
+            _positionVersion++;
+            markHistoryChanged(ply);
+            publish(generation, true);
+            return;
+        }
+    }
+    if(_engine.getBoard()[x][y].piece.type != PieceType::None && !_engine.selectPiece(position)) {
+        _engine.deselectPiece();
+    }
+    publish(generation);
+}
+
+void EngineWorker::selectPosition(quint64 generation, size_t position) {
+    if(_engine.selectPosition(position)) {
+        _positionVersion++;
+    }
+    publish(generation);
+}
+
+void EngineWorker::previousPosition(quint64 generation) {
+    if(_engine.previousPosition() != static_cast<size_t>(-1)) {
+        _positionVersion++;
+    }
+    publish(generation);
+}
+
+void EngineWorker::nextPosition(quint64 generation) {
+    if(_engine.nextPosition() != static_cast<size_t>(-1)) {
+        _positionVersion++;
+    }
+    publish(generation);
+}
+
+void EngineWorker::setBoard(quint64 generation, const QString& fen) {
+    try {
+        _engine.setBoard(fen.toStdString());
+    } catch(std::invalid_argument&) {
+        emit boardRejected(generation, fen);
+        publish(generation);
+        return;
+    }
+    _positionVersion++;
+    _historyReset = true;
+    publish(generation);
+}
+
+bool EngineWorker::isStale(quint64 generation) const {
+    return generation < _latestGeneration.load(std::memory_order_relaxed);
+}
+
+void EngineWorker::markHistoryChanged(size_t firstChangedPly) {
+    if(firstChangedPly < _firstChangedPly) {
+        _firstChangedPly = firstChangedPly;
+    }
+}
+
+void EngineWorker::publish(quint64 generation, bool moved) {
+    if(isStale(generation)) {
+        return;
+    }
+    auto snapshot = std::make_shared<EngineSnapshot>();
+    snapshot->generation = generation;
+    snapshot->positionVersion = _positionVersion;
+    snapshot->game = _engine.getGame();
+    snapshot->state = _engine.getGameState();
+    snapshot->checkPosition = _engine.getCheckPosition();
+    auto selectedSquare = _engine.getSelectedSquare();
+    if(selectedSquare) {
+        snapshot->selectedPosition = selectedSquare->getPosition();
+        auto possibleMoves = _engine.getPossibleMoves();
+        snapshot->possibleMoves.assign(possibleMoves.begin(), possibleMoves.end());
+    } else {
+        snapshot->selectedPosition = std::make_pair(-1, -1);
+    }
+    snapshot->materialImbalance = _engine.getMaterialImbalance();
+    snapshot->positionIndex = _engine.getPositionIndex();
+    snapshot->moved = moved;
+
+    snapshot->historyReset = _historyReset;
+    snapshot->startingMoveIndex = _engine.getStartingMoveIndex();
+    snapshot->firstChangedPly = _historyReset ? 0 : _firstChangedPly;
+    snapshot->changedMoves = _engine.getMoveHistory(snapshot->firstChangedPly);
+    snapshot->firstTurn = _historyReset && !snapshot->changedMoves.empty() ? snapshot->changedMoves.front().getTurn() : _engine.getTurn();
+    _historyReset = false;
+    _firstChangedPly = _engine.getHistorySize();
+
+    emit snapshotReady(snapshot);
+}
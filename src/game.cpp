@@ -1,5 +1,8 @@
 #include "../include/chess/engine/game.hpp"
+#include "../include/chess/engine/stats.hpp"
 #include "../include/chess/engine/string_tok.hpp"
+#include "../include/chess/engine/zobrist.hpp"
+#include <stdexcept>
 #include <utility>
 
 using namespace chess;
@@ -11,6 +14,7 @@ Game::Game(const std::string& fen)
 	  _blackCastleA(false),
       _blackCastleH(false),
       _state(GameState::Playing),
+      _materialKey(0),
       _whiteKingSquare(nullptr),
       _blackKingSquare(nullptr) {
 	StringTok st(fen);
@@ -45,8 +49,21 @@ Game::Game(const std::string& fen)
 					}
 				}
 			}
+			if(getPieceCount(piece.color, piece.type) == 15) {
+				throw std::invalid_argument("");
+			}
+			addMaterial(piece, 1);
 			_board[x++][y].piece = piece;
 		}
+	}
+	// Every pawn may still promote, and the counts hold no more than 15.
+	for(PieceColor color : {PieceColor::White, PieceColor::Black}) {
+		short pawns = getPieceCount(color, PieceType::Pawn);
+		for(PieceType type : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+			if(getPieceCount(color, type) + pawns > 15) {
+				throw std::invalid_argument("");
+			}
+		}
 	}
 		s = st.getNext();
 		if(s == "w") {
@@ -132,9 +149,11 @@ Game::Game(const Game& other)
 	  _blackCastleA(other._blackCastleA),
       _blackCastleH(other._blackCastleH),
       _state(other._state),
+      _materialKey(other._materialKey),
 	  _whiteKingSquare(nullptr),
       _blackKingSquare(nullptr),
       _enPassantSquare(nullptr) {
+	CHESS_STATS_TIME(GameCopies);
 	if(other._enPassantSquare) {
 		_enPassantSquare = &_board[other._enPassantSquare->getPosition()];
 	}
@@ -180,6 +199,7 @@ void Game::swap(Game& other) {
 	std::swap(_blackCastleA, other._blackCastleA);
 	std::swap(_blackCastleH, other._blackCastleH);
     std::swap(_state, other._state);
+    std::swap(_materialKey, other._materialKey);
 }
 
 void Game::move(
@@ -196,12 +216,15 @@ void Game::move(
         _enPassantSquare = &_board[origin.first][(destination.second + origin.second) / 2];
 		break;
 	case MoveType::Promotion:
+        addMaterial(_board[destination].piece, -1);
         _board[destination].piece.type = PieceType::Queen;
+        addMaterial(_board[destination].piece, 1);
 		break;
 	case MoveType::EnPassantCapture:
 	{
 		std::pair<short, short> capturedPiece = _enPassantSquare->getPosition();
 		capturedPiece.second -= _turn == PieceColor::White ? 1 : -1;
+        addMaterial(_board[capturedPiece].piece, -1);
         _board[capturedPiece].piece.type = PieceType::None;
 		break;
 	}
@@ -234,6 +257,9 @@ void Game::movePiece(
 ) {
     Piece movedPiece = _board[origin].piece;
     Piece capturedPiece = _board[destination].piece;
+    if(capturedPiece.type != PieceType::None) {
+        addMaterial(capturedPiece, -1);
+    }
     _board[destination].piece = movedPiece;
 	_board[origin].piece.type = PieceType::None;
     if(movedPiece.type == PieceType::King) {
@@ -268,16 +294,20 @@ void Game::movePiece(
     }
 }
 
+void Game::addMaterial(Piece piece, short count) {
+    size_t shift = 4 * (Piece::colorIndex(piece.color) * 6 + static_cast<size_t>(piece.type) - 1);
+    _materialKey += static_cast<uint64_t>(static_cast<int64_t>(count)) << shift;
+}
 
 void Game::setGameState(GameState state) {
     _state = state;
 }
 
-GameState Game::getGameState() {
+GameState Game::getGameState() const {
     return _state;
 }
 
-Board Game::getBoard() const {
+const Board& Game::getBoard() const {
 	return _board;
 }
 
@@ -304,6 +334,58 @@ short Game::getNoMoves() const {
 	return _noMoves;
 }
 
+uint64_t Game::getHash() const {
+	const zobrist::Keys& keys = zobrist::keys;
+	uint64_t hash = 0;
+	for(short index = 0; index < 64; index++) {
+		Piece piece = _board.getSquare(index).piece;
+		if(piece.type != PieceType::None) {
+			hash ^= keys.pieces[Piece::colorIndex(piece.color)][static_cast<size_t>(piece.type) - 1][index];
+		}
+	}
+	const bool castling[] = {_whiteCastleA, _whiteCastleH, _blackCastleA, _blackCastleH};
+	for(short i = 0; i < 4; i++) {
+		if(castling[i]) {
+			hash ^= keys.castling[i];
+		}
+	}
+	if(getEnPassantPawn() >= 0) {
+		hash ^= keys.enPassant[_enPassantSquare->getX()];
+	}
+	if(_turn == PieceColor::Black) {
+		hash ^= keys.blackToMove;
+	}
+	return hash;
+}
+
+short Game::getEnPassantPawn() const {
+	if(!_enPassantSquare) {
+		return -1;
+	}
+	short y = _enPassantSquare->getY() + (_turn == PieceColor::White ? -1 : 1);
+	if(y < 0 || y > 7) {
+		return -1;
+	}
+	short square = _enPassantSquare->getX() * 8 + y;
+	Piece piece = _board.getSquare(square).piece;
+	if(piece.type != PieceType::Pawn || piece.color == _turn) {
+		return -1;
+	}
+	return square;
+}
+
+short Game::getPieceCount(PieceColor color, PieceType type) const {
+	if(type == PieceType::None) {
+		return 0;
+	}
+	size_t shift = 4 * (Piece::colorIndex(color) * 6 + static_cast<size_t>(type) - 1);
+	return static_cast<short>((_materialKey >> shift) & 0xf);
+}
+
+uint64_t Game::getMaterialKey() const {
+	return _materialKey;
+}
+
 bool Game::canWhiteCastleA() const {
 	return _whiteCastleA;
 }
@@ -0,0 +1,165 @@
+#include "../include/chess/engine/game_archive.hpp"
+#include "../include/chess/engine/arena.hpp"
+#include "../include/chess/engine/rules.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace chess;
+
+namespace {
+
+const char Magic[4] = {'C', 'G', 'A', '1'};
+const uint8_t ResultMask = 3;
+const uint8_t CustomStart = 4;
+
+void writeShort(std::ostream& os, short value) {
+    uint16_t bits = static_cast<uint16_t>(value);
+    os.put(static_cast<char>(bits & 0xff));
+    os.put(static_cast<char>(bits >> 8));
+}
+
+}
+
+const size_t ArchivedGame::MaxPlies;
+
+ArchivedGame::ArchivedGame()
+    : customStart(false), start(), noHalfMoves(0), noMoves(1),
+      result(GameState::Playing), moves() {}
+
+Game ArchivedGame::getStartingPosition() const {
+    if(!customStart) {
+        return Game();
+    }
+    return start.unpack(noHalfMoves, noMoves);
+}
+
+void ArchivedGame::replay(const std::function<void(const Game&, const Move&)>& visitor) const {
+    Game game = getStartingPosition();
+    Arena& arena = Arena::local();
+    for(uint8_t index : moves) {
+        Arena::Scope scope(arena);
+        auto legalMoves = rules::legalMoves(game, &arena);
+        if(index >= legalMoves.size()) {
+            throw std::invalid_argument("Error: Move index out of range in game archive");
+        }
+        Move move = legalMoves[index];
+        visitor(game, move);
+        game.move(move.origin, move.destination, move.type);
+    }
+}
+
+std::vector<Move> ArchivedGame::getMoves() const {
+    std::vector<Move> result;
+    result.reserve(moves.size());
+    replay([&](const Game&, const Move& move) {
+        result.push_back(move);
+    });
+    return result;
+}
+
+GameArchiveWriter::GameArchiveWriter(std::ostream& os)
+    : _os(os), _noGames(0) {
+    _os.write(Magic, sizeof(Magic));
+}
+
+void GameArchiveWriter::write(const Engine& engine, GameState result) {
+    write(engine.getStartingPosition(), engine.getMoves(), result);
+}
+
+void GameArchiveWriter::write(const Game& start, const std::vector<Move>& moves, GameState result) {
+    if(moves.size() > ArchivedGame::MaxPlies) {
+        throw std::invalid_argument("Error: Too many plies for a game archive");
+    }
+    std::vector<uint8_t> indexes;
+    indexes.reserve(moves.size());
+    Game game(start);
+    Arena& arena = Arena::local();
+    for(const Move& move : moves) {
+        Arena::Scope scope(arena);
+        auto legalMoves = rules::legalMoves(game, &arena);
+        auto found = std::find(legalMoves.begin(), legalMoves.end(), move);
+        if(found == legalMoves.end()) {
+            throw std::invalid_argument("Error: Illegal move " + move.getCoordinateNotation() + " in archived game");
+        }
+        indexes.push_back(static_cast<uint8_t>(found - legalMoves.begin()));
+        game.move(move.origin, move.destination, move.type);
+    }
+
+    PackedPosition packed(start);
+    bool customStart = packed != PackedPosition(Game()) || start.getNoHalfMoves() != 0 || start.getNoMoves() != 1;
+    _os.put(static_cast<char>((static_cast<uint8_t>(result) & ResultMask) | (customStart ? CustomStart : 0)));
+    if(customStart) {
+        _os.write(reinterpret_cast<const char*>(&packed), sizeof(packed));
+        writeShort(_os, start.getNoHalfMoves());
+        writeShort(_os, start.getNoMoves());
+    }
+    for(size_t plies = indexes.size(); ; plies >>= 7) {
+        uint8_t byte = plies & 0x7f;
+        if(plies >> 7) {
+            _os.put(static_cast<char>(byte | 0x80));
+        } else {
+            _os.put(static_cast<char>(byte));
+            break;
+        }
+    }
+    _os.write(reinterpret_cast<const char*>(indexes.data()), static_cast<std::streamsize>(indexes.size()));
+    _noGames++;
+}
+
+size_t GameArchiveWriter::getNoGames() const {
+    return _noGames;
+}
+
+GameArchiveReader::GameArchiveReader(std::istream& is)
+    : _is(is) {
+    char magic[sizeof(Magic)];
+    if(!_is.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0) {
+        throw std::invalid_argument("Error: Not a game archive");
+    }
+}
+
+bool GameArchiveReader::read(ArchivedGame& game) {
+    int flags = _is.get();
+    if(flags == std::istream::traits_type::eof()) {
+        return false;
+    }
+    game.result = static_cast<GameState>(flags & ResultMask);
+    game.customStart = flags & CustomStart;
+    game.noHalfMoves = 0;
+    game.noMoves = 1;
+    if(game.customStart) {
+        uint8_t counters[4];
+        readBytes(&game.start, sizeof(game.start));
+        if(!game.start.isValid()) {
+            throw std::invalid_argument("Error: Invalid starting position in game archive");
+        }
+        readBytes(counters, sizeof(counters));
+        game.noHalfMoves = static_cast<short>(counters[0] | counters[1] << 8);
+        game.noMoves = static_cast<short>(counters[2] | counters[3] << 8);
+    }
+    size_t plies = 0;
+    for(short shift = 0; ; shift += 7) {
+        uint8_t byte;
+        readBytes(&byte, 1);
+        if(shift > 28) {
+            throw std::invalid_argument("Error: Invalid ply count in game archive");
+        }
+        plies |= static_cast<size_t>(byte & 0x7f) << shift;
+        if(!(byte & 0x80)) {
+            break;
+        }
+    }
+    if(plies > ArchivedGame::MaxPlies) {
+        throw std::invalid_argument("Error: Invalid ply count in game archive");
+    }
+    game.moves.resize(plies);
+    readBytes(game.moves.data(), plies);
+    return true;
+}
+
+void GameArchiveReader::readBytes(void* data, size_t size) {
+    if(!_is.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::invalid_argument("Error: Truncated game archive");
+    }
+}
@@ -1,12 +1,14 @@
 #include "../include/chess/engine/game_rules.hpp"
+#include "../include/chess/engine/arena.hpp"
 #include "../include/chess/engine/pressure_factory.hpp"
+#include "../include/chess/engine/stats.hpp"
 #include <algorithm>
 #include <iterator>
 
 using namespace chess;
 
 GameRules::GameRules(const Game& game)
-	: _moves() {
+	: _pool(), _moves(&_pool) {
 	selectGame(game);
 }
 
@@ -16,7 +18,6 @@ void GameRules::selectGame(const Game& game) {
 }
 
 void GameRules::updatePosition() {
-    _board = _game->getBoard();
     deselectSquare();
 }
 
@@ -24,7 +25,7 @@ bool GameRules::selectSquare(const std::pair<short, short>& position) {
     if(!Board::positionExists(position)) {
 		return false;
     }
-    _currentSquare = &_board[position];
+    _currentSquare = &getBoard()[position];
     Piece piece = _currentSquare->piece;
     if(piece.type != PieceType::None && piece.color == _game->getTurn()) {
         updatePossibleMoves();
@@ -58,7 +59,7 @@ bool GameRules::isCheck(PieceColor turn) {
 	return enemyCanAttack(_game->getBoard(), kingPosition);
 }
 
-Square* GameRules::getSelectedSquare() {
+const Square* GameRules::getSelectedSquare() const {
     return _currentSquare;
 }
 
@@ -69,6 +70,40 @@ std::unordered_set<std::pair<short, short>, PairHash> GameRules::getPossibleMove
 	return moves;
 }
 
+bool GameRules::hasPossibleMoves() const {
+	return !_moves.empty();
+}
+
+std::pmr::vector<Move> GameRules::getLegalMoves(std::pmr::memory_resource* resource) {
+	std::pmr::vector<Move> legalMoves(resource);
+	legalMoves.reserve(64);
+	for(short x = 0; x < 8; x++) {
+		for(short y = 0; y < 8; y++) {
+			auto origin = std::make_pair(x, y);
+			if(selectSquare(origin)) {
+				for(auto movePair : _moves) {
+					legalMoves.push_back(Move(origin, movePair.first, movePair.second));
+				}
+			}
+		}
+	}
+	deselectSquare();
+	return legalMoves;
+}
+
+bool GameRules::hasLegalMoves() {
+	for(short x = 0; x < 8; x++) {
+		for(short y = 0; y < 8; y++) {
+			if(selectSquare(std::make_pair(x, y)) && hasPossibleMoves()) {
+				deselectSquare();
+				return true;
+			}
+		}
+	}
+	deselectSquare();
+	return false;
+}
+
 void GameRules::updatePossibleMoves() {
     _moves.clear();
 	setPossibleMoves();
@@ -76,8 +111,9 @@ void GameRules::updatePossibleMoves() {
 }
 
 void GameRules::setPossibleMoves() {
-	PressureFactory pressureFactory(_game->getBoard(), _currentSquare->getPosition());
-	auto m = pressureFactory.getMoves();
+	Arena::Scope scope(Arena::local());
+	PressureFactory pressureFactory(_game->getBoard(), _currentSquare->getPosition(), &Arena::local());
+	const auto& m = pressureFactory.getMoves();
 	_moves.insert(m.begin(), m.end());
     Piece piece = _currentSquare->piece;
     if(piece.type == PieceType::Pawn) {
@@ -85,11 +121,11 @@ void GameRules::setPossibleMoves() {
 		short y = _currentSquare->getY();
 		short step = _currentSquare->piece.color == PieceColor::White ? 1 : -1;
 		MoveType moveType = (y + step) == 0 || (y + step) == 7 ? MoveType::Promotion : MoveType::Normal;
-		if(_board[x][y + step].piece.type == PieceType::None) {
+		if(getBoard()[x][y + step].piece.type == PieceType::None) {
             addMove(x, y + step, moveType);
 			if(y == 1 || y == 6) {
 				if(Board::positionExists(x, y + 2 * step)) {
-                    if(_board[x][y + 2 * step].piece.type == PieceType::None) {
+                    if(getBoard()[x][y + 2 * step].piece.type == PieceType::None) {
 						addMove(x, y + 2 * step, MoveType::PawnDouble);
 					}
 				}
@@ -104,7 +140,7 @@ void GameRules::setPossibleMoves() {
             removeMove(x - 1, y + step);
         }
 
-        Square* enPassant = _game->getEnPassantSquare();
+        const Square* enPassant = _game->getEnPassantSquare();
         if(enPassant) {
             if(enPassant->getY() == y + step) {
                 if(enPassant->getX() == x + 1) {
@@ -140,7 +176,10 @@ void GameRules::setPossibleMoves() {
 }
 
 void GameRules::removeInvalidMoves() {
-	auto moveCopy = _moves;
+	Arena::Scope scope(Arena::local());
+	std::pmr::vector<std::pair<std::pair<short, short>, MoveType>> moveCopy(
+		_moves.begin(), _moves.end(), &Arena::local()
+	);
 	if(_currentSquare->piece.type == PieceType::King) {
 		for(auto movePair : moveCopy) {
 			Game game = *_game;
@@ -157,8 +196,13 @@ void GameRules::removeInvalidMoves() {
 			kingPosition = _game->getBlackKingSquare()->getPosition();
 		}
 		std::pair<short, short> piecePosition = _currentSquare->getPosition();
+		bool canExposeKing = !moveCopy.empty() && (isOnOpenLine(kingPosition, piecePosition)
+			|| isCheck(_currentSquare->piece.color));
 
 		for(auto movePair : moveCopy) {
+			if(!canExposeKing && movePair.second != MoveType::EnPassantCapture) {
+				continue;
+			}
 			Game game = *_game;
 			game.move(piecePosition, movePair.first, movePair.second);
 			if(enemyCanAttack(game.getBoard(), kingPosition)) {
@@ -171,11 +215,11 @@ void GameRules::removeInvalidMoves() {
 
 bool GameRules::whiteCanCastleA() {
 	if(_game->canWhiteCastleA()) {
-        if(_board[0][0].piece.type != PieceType::Rook) {
+        if(getBoard()[0][0].piece.type != PieceType::Rook) {
             return false;
         }
 		for(short x = 1; x <= _game->getWhiteKingSquare()->getX(); x++) {
-			Piece piece = _board[x][0].piece;
+			Piece piece = getBoard()[x][0].piece;
 			if(piece.type != PieceType::None) {
 				if(piece.type != PieceType::King || piece.color != PieceColor::White) {
 					return false;
@@ -190,12 +234,12 @@ bool GameRules::whiteCanCastleA() {
 	return false;
 }
 bool GameRules::whiteCanCastleH() {
-    if(_board[7][0].piece.type != PieceType::Rook) {
+    if(getBoard()[7][0].piece.type != PieceType::Rook) {
         return false;
     }
 	if(_game->canWhiteCastleH()) {
 		for(short x = 6; x >= _game->getWhiteKingSquare()->getX(); x--) {
-			Piece piece = _board[x][0].piece;
+			Piece piece = getBoard()[x][0].piece;
 			if(piece.type != PieceType::None) {
 				if(piece.type != PieceType::King || piece.color != PieceColor::White) {
 					return false;
@@ -211,12 +255,12 @@ bool GameRules::whiteCanCastleH() {
 }
 
 bool GameRules::blackCanCastleA() {
-    if(_board[0][7].piece.type != PieceType::Rook) {
+    if(getBoard()[0][7].piece.type != PieceType::Rook) {
         return false;
     }
 	if(_game->canBlackCastleA()) {
 		for(short x = 1; x <= _game->getBlackKingSquare()->getX(); x++) {
-			Piece piece = _board[x][7].piece;
+			Piece piece = getBoard()[x][7].piece;
 			if(piece.type != PieceType::None) {
 				if(piece.type != PieceType::King || piece.color != PieceColor::Black) {
 					return false;
@@ -231,12 +275,12 @@ bool GameRules::blackCanCastleA() {
 	return false;
 }
 bool GameRules::blackCanCastleH() {
-    if(_board[7][7].piece.type != PieceType::Rook) {
+    if(getBoard()[7][7].piece.type != PieceType::Rook) {
         return false;
     }
 	if(_game->canBlackCastleH()) {
 		for(short x = 6; x >= _game->getBlackKingSquare()->getX(); x--) {
-			Piece piece = _board[x][7].piece;
+			Piece piece = getBoard()[x][7].piece;
 			if(piece.type != PieceType::None) {
 				if(piece.type != PieceType::King || piece.color != PieceColor::Black) {
 					return false;
@@ -251,7 +295,7 @@ bool GameRules::blackCanCastleH() {
 	return false;
 }
 
-Square* GameRules::getPinningSquare(short originX, short originY, short stepX, short stepY) {
+const Square* GameRules::getPinningSquare(short originX, short originY, short stepX, short stepY) {
 	short outOfRangeX = originX;
 	short outOfRangeY = originY;
 	if(stepX > 0) {
@@ -271,7 +315,7 @@ Square* GameRules::getPinningSquare(short originX, short originY, short stepX, s
 
 	for(short x = originX; x != outOfRangeX; x += stepX) {
 		for(short y = originY; y != outOfRangeY; y += stepY) {
-			Square* square = &_board[x][y];
+			const Square* square = &getBoard()[x][y];
 			if(square->piece.type != PieceType::None) {
 				return square;
 			}
@@ -280,13 +324,29 @@ Square* GameRules::getPinningSquare(short originX, short originY, short stepX, s
 	return nullptr;
 }
 
-bool GameRules::enemyCanAttack(Board board, const std::pair<short, short>& destination) {
+bool GameRules::isOnOpenLine(const std::pair<short, short>& from, const std::pair<short, short>& to) const {
+	short origin = from.first * 8 + from.second;
+	short destination = to.first * 8 + to.second;
+	if(!lineMasks[origin][destination]) {
+		return false;
+	}
+	for(uint64_t between = betweenMasks[origin][destination]; between; between &= between - 1) {
+		if(getBoard().getSquare(lowestSquare(between)).piece.type != PieceType::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GameRules::enemyCanAttack(const Board& board, const std::pair<short, short>& destination) {
+	CHESS_STATS_TIME(EnemyCanAttack);
 	for(short x = 0; x < 8; x++) {
 		for(short y = 0; y < 8; y++) {
 			Piece piece = board[x][y].piece;
 			if(piece.type != PieceType::None) {
 				if(piece.color != _game->getTurn()) {
-					PressureFactory enemy(board, std::make_pair(x, y));
+					Arena::Scope scope(Arena::local());
+					PressureFactory enemy(board, std::make_pair(x, y), &Arena::local());
 					if(enemy.canAttack(destination)) {
 						return true;
 					}
@@ -297,12 +357,16 @@ bool GameRules::enemyCanAttack(Board board, const std::pair<short, short>& desti
 	return false;
 }
 
+const Board& GameRules::getBoard() const {
+	return _game->getBoard();
+}
+
 void GameRules::addMove(const std::pair<short, short>& destination, MoveType moveType) {
 	if(!Board::positionExists(destination)) {
 		return;
 	}
 
-	Piece targetPiece = _board[destination].piece;
+	Piece targetPiece = getBoard()[destination].piece;
 	if(targetPiece.type != PieceType::None) {
 		if(targetPiece.color == _currentSquare->piece.color) {
 			return;
@@ -319,7 +383,7 @@ bool GameRules::isEnemy(const std::pair<short, short>& position) {
 	if(!Board::positionExists(position)) {
 		return false;
 	}
-	Piece piece = _board[position].piece;
+	Piece piece = getBoard()[position].piece;
 	if(piece.type != PieceType::None) {
 		return _currentSquare->piece.color != piece.color;
 	} else {
@@ -0,0 +1,75 @@
+#include "../include/chess/engine/legal_move_cache.hpp"
+#include <algorithm>
+
+using namespace chess;
+
+LegalMoves::LegalMoves(const Move* first, const Move* last)
+    : _moves(static_cast<size_t>(last - first)), _offsets() {
+    std::array<uint8_t, 64> counts{};
+    for(const Move* move = first; move != last; move++) {
+        counts[move->origin.first * 8 + move->origin.second]++;
+    }
+    for(short square = 0; square < 64; square++) {
+        _offsets[square + 1] = static_cast<uint8_t>(_offsets[square] + counts[square]);
+    }
+    std::array<uint8_t, 64> next;
+    std::copy(_offsets.begin(), _offsets.end() - 1, next.begin());
+    for(const Move* move = first; move != last; move++) {
+        _moves[next[move->origin.first * 8 + move->origin.second]++] = *move;
+    }
+}
+
+const std::vector<Move>& LegalMoves::getMoves() const {
+    return _moves;
+}
+
+const Move* LegalMoves::begin(short origin) const {
+    return _moves.data() + _offsets[origin];
+}
+
+const Move* LegalMoves::end(short origin) const {
+    return _moves.data() + _offsets[origin + 1];
+}
+
+bool LegalMoves::empty() const {
+    return _moves.empty();
+}
+
+LegalMoveCache::LegalMoveCache()
+    : _entries(), _clock(0) {
+    _entries.reserve(Capacity);
+}
+
+std::shared_ptr<const LegalMoves> LegalMoveCache::find(uint64_t hash) {
+    for(auto& entry : _entries) {
+        if(entry.hash == hash) {
+            entry.lastUse = ++_clock;
+            return entry.moves;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const LegalMoves> LegalMoveCache::insert(uint64_t hash, std::shared_ptr<const LegalMoves> moves) {
+    if(_entries.size() < Capacity) {
+        _entries.push_back(Entry{hash, ++_clock, moves});
+    } else {
+        auto oldest = std::min_element(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+            return a.lastUse < b.lastUse;
+        });
+        *oldest = Entry{hash, ++_clock, moves};
+    }
+    return moves;
+}
+
+void LegalMoveCache::clear() {
+    _entries.clear();
+}
+
+size_t LegalMoveCache::getMemoryUsage() const {
+    size_t usage = _entries.capacity() * sizeof(Entry);
+    for(const auto& entry : _entries) {
+        usage += sizeof(LegalMoves) + entry.moves->getMoves().capacity() * sizeof(Move);
+    }
+    return usage;
+}
@@ -0,0 +1,32 @@
+#include "../include/chess/engine/move.hpp"
+#include "../include/chess/engine/square.hpp"
+
+using namespace chess;
+
+Move::Move()
+    : origin(-1, -1), destination(-1, -1), type(MoveType::None) {}
+
+Move::Move(
+        const std::pair<short, short>& origin,
+        const std::pair<short, short>& destination,
+        MoveType type
+) : origin(origin), destination(destination), type(type) {}
+
+bool Move::operator==(const Move& other) const {
+    return origin == other.origin && destination == other.destination && type == other.type;
+}
+
+bool Move::operator!=(const Move& other) const {
+    return !(*this == other);
+}
+
+std::string Move::getCoordinateNotation() const {
+    if(type == MoveType::None) {
+        return "0000";
+    }
+    std::string notation = Square::convertPosition(origin) + Square::convertPosition(destination);
+    if(type == MoveType::Promotion) {
+        notation += 'q';
+    }
+    return notation;
+}
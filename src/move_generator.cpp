@@ -0,0 +1,365 @@
+#include "../include/chess/engine/move_generator.hpp"
+#include "../include/chess/engine/attack_tables.hpp"
+#include "../include/chess/engine/rules.hpp"
+#include "../include/chess/engine/stats.hpp"
+#include <algorithm>
+
+using namespace chess;
+
+namespace {
+
+const short FirstOrthogonal = static_cast<short>(Direction::North);
+const short LastOrthogonal = static_cast<short>(Direction::West);
+const short FirstDiagonal = static_cast<short>(Direction::NorthEast);
+const short LastDiagonal = static_cast<short>(Direction::NorthWest);
+
+// Taking a king ends the exchange, so it outweighs anything else on the board.
+const int ExchangeKingValue = 20000;
+
+int exchangeValue(PieceType type) {
+    return type == PieceType::King ? ExchangeKingValue : rules::pieceValue(type);
+}
+
+uint64_t bit(short square) {
+    return uint64_t(1) << square;
+}
+
+std::pair<short, short> toPosition(short square) {
+    return std::make_pair(static_cast<short>(square / 8), static_cast<short>(square % 8));
+}
+
+}
+
+MoveGenerator::MoveGenerator(const Game& game)
+    : _game(game),
+      _us(game.getTurn()),
+      _them(game.getTurn() == PieceColor::White ? PieceColor::Black : PieceColor::White),
+      _occupied(0),
+      _colors(),
+      _pieces(),
+      _king(-1),
+      _checkers(0),
+      _pinned(0) {
+    const Board& board = game.getBoard();
+    for(short square = 0; square < 64; square++) {
+        Piece piece = board.getSquare(square).piece;
+        if(piece.type != PieceType::None) {
+            _colors[piece.color == PieceColor::White ? 0 : 1] |= bit(square);
+            _pieces[static_cast<size_t>(piece.type)] |= bit(square);
+        }
+    }
+    _occupied = _colors[0] | _colors[1];
+    const Square* king = _us == PieceColor::White ? game.getWhiteKingSquare() : game.getBlackKingSquare();
+    if(!king) {
+        return;
+    }
+    _king = static_cast<short>(king->getX() * 8 + king->getY());
+    _checkers = getAttackers(_king, _them);
+
+    uint64_t own = _colors[Piece::colorIndex(_us)];
+    uint64_t enemy = _colors[Piece::colorIndex(_them)];
+    uint64_t rookLike = (_pieces[static_cast<size_t>(PieceType::Rook)] | _pieces[static_cast<size_t>(PieceType::Queen)]) & enemy;
+    uint64_t bishopLike = (_pieces[static_cast<size_t>(PieceType::Bishop)] | _pieces[static_cast<size_t>(PieceType::Queen)]) & enemy;
+    for(short direction = FirstOrthogonal; direction <= LastDiagonal; direction++) {
+        uint64_t pinners = direction <= LastOrthogonal ? rookLike : bishopLike;
+        short blocker = -1;
+        for(uint8_t square : rays[_king][direction]) {
+            if(!(_occupied & bit(square))) {
+                continue;
+            }
+            if(blocker < 0 && (own & bit(square))) {
+                blocker = square;
+                continue;
+            }
+            if(blocker >= 0 && (pinners & bit(square))) {
+                _pinned |= bit(blocker);
+            }
+            break;
+        }
+    }
+}
+
+std::pmr::vector<Move> MoveGenerator::getLegalMoves(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<Move> moves(resource);
+    moves.reserve(64);
+    generate(&moves);
+    return moves;
+}
+
+bool MoveGenerator::hasLegalMoves() const {
+    return generate(nullptr);
+}
+
+bool MoveGenerator::isCheck() const {
+    return _checkers != 0;
+}
+
+uint64_t MoveGenerator::getAttackers(short square, PieceColor color) const {
+    return getAttackers(square, color, _occupied);
+}
+
+uint64_t MoveGenerator::getAttackers(short square, PieceColor color, uint64_t occupied) const {
+    CHESS_STATS_TIME(GetAttackers);
+    size_t index = Piece::colorIndex(color);
+    uint64_t attackers = (knightMasks[square] & _pieces[static_cast<size_t>(PieceType::Knight)])
+        | (kingMasks[square] & _pieces[static_cast<size_t>(PieceType::King)])
+        | (pawnAttackMasks[1 - index][square] & _pieces[static_cast<size_t>(PieceType::Pawn)]);
+    uint64_t pieces = _colors[index] & occupied;
+    uint64_t queens = _pieces[static_cast<size_t>(PieceType::Queen)];
+    uint64_t rookLike = (_pieces[static_cast<size_t>(PieceType::Rook)] | queens) & pieces;
+    uint64_t bishopLike = (_pieces[static_cast<size_t>(PieceType::Bishop)] | queens) & pieces;
+    if(rookLike) {
+        attackers |= getRayAttacks(square, FirstOrthogonal, LastOrthogonal, occupied) & rookLike;
+    }
+    if(bishopLike) {
+        attackers |= getRayAttacks(square, FirstDiagonal, LastDiagonal, occupied) & bishopLike;
+    }
+    return attackers & pieces;
+}
+
+uint64_t MoveGenerator::getOccupied() const {
+    return _occupied;
+}
+
+// The swap algorithm: gains[depth] is what the side making capture number
+// depth is up if the exchange stops right after it, and folding the list
+// back lets either side stand pat when capturing on would lose material.
+// Attackers are looked up again after every capture, which brings in the
+// sliders that were behind the piece that just left.
+int MoveGenerator::see(const Move& move) const {
+    short origin = move.origin.first * 8 + move.origin.second;
+    short target = move.destination.first * 8 + move.destination.second;
+    short promotionY = _us == PieceColor::White ? 7 : 0;
+    uint64_t occupied = _occupied & ~bit(origin);
+    int gains[32];
+    short depth = 0;
+    gains[0] = rules::pieceValue(_game.getBoard().getSquare(target).piece.type);
+    PieceType onTarget = _game.getBoard().getSquare(origin).piece.type;
+    if(move.type == MoveType::EnPassantCapture) {
+        gains[0] = rules::pieceValue(PieceType::Pawn);
+        occupied &= ~bit(target + (_us == PieceColor::White ? -1 : 1));
+    } else if(move.type == MoveType::Promotion) {
+        gains[0] += rules::pieceValue(PieceType::Queen) - rules::pieceValue(PieceType::Pawn);
+        onTarget = PieceType::Queen;
+    }
+    PieceColor side = _them;
+    while(depth < 31) {
+        short square;
+        PieceType attacker = getLeastValuable(getAttackers(target, side, occupied), square);
+        if(attacker == PieceType::None) {
+            break;
+        }
+        depth++;
+        gains[depth] = exchangeValue(onTarget) - gains[depth - 1];
+        onTarget = attacker;
+        if(attacker == PieceType::Pawn && target % 8 == (side == _us ? promotionY : 7 - promotionY)) {
+            gains[depth] += rules::pieceValue(PieceType::Queen) - rules::pieceValue(PieceType::Pawn);
+            onTarget = PieceType::Queen;
+        }
+        occupied &= ~bit(square);
+        side = side == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    }
+    while(depth > 0) {
+        depth--;
+        gains[depth] = -std::max(-gains[depth], gains[depth + 1]);
+    }
+    return gains[0];
+}
+
+PieceType MoveGenerator::getLeastValuable(uint64_t pieces, short& square) const {
+    for(size_t type = static_cast<size_t>(PieceType::Pawn); type <= static_cast<size_t>(PieceType::King); type++) {
+        uint64_t candidates = pieces & _pieces[type];
+        if(candidates) {
+            square = lowestSquare(candidates);
+            return static_cast<PieceType>(type);
+        }
+    }
+    return PieceType::None;
+}
+
+bool MoveGenerator::generate(std::pmr::vector<Move>* moves) const {
+    CHESS_STATS_TIME(MoveGeneration);
+    if(_king < 0) {
+        return false;
+    }
+    bool found = generateKingMoves(moves);
+    if(found && !moves) {
+        return true;
+    }
+    // In double check only the king can move.
+    if(_checkers & (_checkers - 1)) {
+        return found;
+    }
+
+    uint64_t own = _colors[Piece::colorIndex(_us)];
+    uint64_t allowed = ~own;
+    if(_checkers) {
+        short checker = lowestSquare(_checkers);
+        allowed &= _checkers | betweenMasks[_king][checker];
+    }
+    const Board& board = _game.getBoard();
+    for(uint64_t pieces = own & ~bit(_king); pieces; pieces &= pieces - 1) {
+        short origin = lowestSquare(pieces);
+        uint64_t targets = allowed;
+        if(_pinned & bit(origin)) {
+            targets &= lineMasks[_king][origin];
+        }
+        switch(board.getSquare(origin).piece.type) {
+        case PieceType::Pawn:
+            found = generatePawnMoves(origin, targets, moves) || found;
+            continue;
+        case PieceType::Knight:
+            targets &= knightMasks[origin];
+            break;
+        case PieceType::Bishop:
+            targets &= getRayAttacks(origin, FirstDiagonal, LastDiagonal, _occupied);
+            break;
+        case PieceType::Rook:
+            targets &= getRayAttacks(origin, FirstOrthogonal, LastOrthogonal, _occupied);
+            break;
+        case PieceType::Queen:
+            targets &= getRayAttacks(origin, FirstOrthogonal, LastDiagonal, _occupied);
+            break;
+        default:
+            continue;
+        }
+        for(; targets; targets &= targets - 1) {
+            found = true;
+            if(!addMove(origin, lowestSquare(targets), MoveType::Normal, moves)) {
+                return true;
+            }
+        }
+    }
+    return found;
+}
+
+bool MoveGenerator::generatePawnMoves(short origin, uint64_t allowed, std::pmr::vector<Move>* moves) const {
+    bool found = false;
+    short y = origin % 8;
+    short step = _us == PieceColor::White ? 1 : -1;
+    if(y + step < 0 || y + step > 7) {
+        return false;
+    }
+    MoveType type = y + step == 0 || y + step == 7 ? MoveType::Promotion : MoveType::Normal;
+
+    short forward = origin + step;
+    if(!(_occupied & bit(forward))) {
+        if(allowed & bit(forward)) {
+            found = true;
+            if(!addMove(origin, forward, type, moves)) {
+                return true;
+            }
+        }
+        short twoForward = forward + step;
+        if((y == 1 || y == 6) && y + 2 * step >= 0 && y + 2 * step <= 7
+                && !(_occupied & bit(twoForward)) && (allowed & bit(twoForward))) {
+            found = true;
+            if(!addMove(origin, twoForward, MoveType::PawnDouble, moves)) {
+                return true;
+            }
+        }
+    }
+
+    uint64_t captures = pawnAttackMasks[Piece::colorIndex(_us)][origin];
+    for(uint64_t targets = captures & _colors[Piece::colorIndex(_them)] & allowed; targets; targets &= targets - 1) {
+        found = true;
+        if(!addMove(origin, lowestSquare(targets), type, moves)) {
+            return true;
+        }
+    }
+
+    const Square* enPassant = _game.getEnPassantSquare();
+    if(enPassant) {
+        short destination = static_cast<short>(enPassant->getX() * 8 + enPassant->getY());
+        if((captures & bit(destination)) && !(_occupied & bit(destination)) && isEnPassantLegal(origin, destination)) {
+            found = true;
+            if(!addMove(origin, destination, MoveType::EnPassantCapture, moves)) {
+                return true;
+            }
+        }
+    }
+    return found;
+}
+
+bool MoveGenerator::generateKingMoves(std::pmr::vector<Move>* moves) const {
+    bool found = false;
+    uint64_t withoutKing = _occupied & ~bit(_king);
+    for(uint64_t targets = kingMasks[_king] & ~_colors[Piece::colorIndex(_us)]; targets; targets &= targets - 1) {
+        short destination = lowestSquare(targets);
+        if(getAttackers(destination, _them, withoutKing)) {
+            continue;
+        }
+        found = true;
+        if(!addMove(_king, destination, MoveType::Normal, moves)) {
+            return true;
+        }
+    }
+
+    short homeY = _us == PieceColor::White ? 0 : 7;
+    if(_king != 4 * 8 + homeY) {
+        return found;
+    }
+    bool castleA = _us == PieceColor::White ? _game.canWhiteCastleA() : _game.canBlackCastleA();
+    bool castleH = _us == PieceColor::White ? _game.canWhiteCastleH() : _game.canBlackCastleH();
+    if(castleA && canCastle(0, 1)) {
+        found = true;
+        if(!addMove(_king, 2 * 8 + homeY, MoveType::Castle, moves)) {
+            return true;
+        }
+    }
+    if(castleH && canCastle(7, 6)) {
+        found = true;
+        if(!addMove(_king, 6 * 8 + homeY, MoveType::Castle, moves)) {
+            return true;
+        }
+    }
+    return found;
+}
+
+// Like GameRules, every square from lastX to the king must be empty and
+// safe, which on the A side includes the knight's square.
+bool MoveGenerator::canCastle(short rookX, short lastX) const {
+    short homeY = _king % 8;
+    if(_game.getBoard().getSquare(rookX * 8 + homeY).piece.type != PieceType::Rook) {
+        return false;
+    }
+    short step = lastX < 4 ? 1 : -1;
+    for(short x = lastX; x != 4 + step; x += step) {
+        short square = x * 8 + homeY;
+        if(square != _king && (_occupied & bit(square))) {
+            return false;
+        }
+        if(getAttackers(square, _them)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MoveGenerator::isEnPassantLegal(short origin, short destination) const {
+    short captured = destination - (_us == PieceColor::White ? 1 : -1);
+    uint64_t occupied = (_occupied & ~bit(origin) & ~bit(captured)) | bit(destination);
+    return !getAttackers(_king, _them, occupied);
+}
+
+uint64_t MoveGenerator::getRayAttacks(short square, short firstDirection, short lastDirection, uint64_t occupied) {
+    uint64_t attacks = 0;
+    for(short direction = firstDirection; direction <= lastDirection; direction++) {
+        for(uint8_t target : rays[square][direction]) {
+            attacks |= bit(target);
+            if(occupied & bit(target)) {
+                break;
+            }
+        }
+    }
+    return attacks;
+}
+
+// Returns false once the caller only wanted to know a move exists.
+bool MoveGenerator::addMove(short origin, short destination, MoveType type, std::pmr::vector<Move>* moves) {
+    if(!moves) {
+        return false;
+    }
+    moves->push_back(Move(toPosition(origin), toPosition(destination), type));
+    return true;
+}
@@ -0,0 +1,111 @@
+#include "../include/chess/move_history_model.hpp"
+#include "../include/chess/engine/piece.hpp"
+
+using namespace chess;
+
+MoveHistoryModel::MoveHistoryModel(QObject* parent)
+    : QAbstractTableModel(parent), _moves(), _offset(0), _startingMoveIndex(1) {}
+
+int MoveHistoryModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : getRowCount(_moves.size());
+}
+
+int MoveHistoryModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : 2;
+}
+
+QVariant MoveHistoryModel::data(const QModelIndex& index, int role) const {
+    if(role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    size_t ply = getPly(index);
+    if(ply >= _moves.size()) {
+        return QVariant();
+    }
+    return _moves[ply];
+}
+
+QVariant MoveHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if(role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if(orientation == Qt::Vertical) {
+        return QString::number(_startingMoveIndex + section);
+    }
+    return section == 0 ? QString("White") : QString("Black");
+}
+
+Qt::ItemFlags MoveHistoryModel::flags(const QModelIndex& index) const {
+    if(getPly(index) >= _moves.size()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void MoveHistoryModel::reset(PieceColor firstTurn, short startingMoveIndex) {
+    beginResetModel();
+    _moves.clear();
+    _offset = static_cast<int>(Piece::colorIndex(firstTurn));
+    _startingMoveIndex = startingMoveIndex;
+    endResetModel();
+}
+
+void MoveHistoryModel::update(size_t firstChangedPly, const std::vector<MoveInfo>& moves) {
+    if(firstChangedPly > _moves.size()) {
+        firstChangedPly = _moves.size();
+    }
+    if(firstChangedPly < _moves.size()) {
+        int oldRows = getRowCount(_moves.size());
+        int newRows = getRowCount(firstChangedPly);
+        if(newRows < oldRows) {
+            beginRemoveRows(QModelIndex(), newRows, oldRows - 1);
+            _moves.resize(firstChangedPly);
+            endRemoveRows();
+        } else {
+            _moves.resize(firstChangedPly);
+        }
+        QModelIndex changed = getIndex(firstChangedPly);
+        if(changed.row() < newRows) {
+            emit dataChanged(index(changed.row(), 0), index(changed.row(), 1));
+        }
+    }
+    size_t skipped = firstChangedPly < _moves.size() ? _moves.size() - firstChangedPly : 0;
+    if(moves.size() > skipped) {
+        size_t firstNewPly = _moves.size();
+        int oldRows = getRowCount(firstNewPly);
+        int newRows = getRowCount(firstNewPly + moves.size() - skipped);
+        if(newRows > oldRows) {
+            beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        }
+        for(size_t i = skipped; i < moves.size(); i++) {
+            _moves.push_back(QString::fromStdString(moves[i].getAlgebraicNotation()));
+        }
+        if(newRows > oldRows) {
+            endInsertRows();
+        }
+        int firstRow = getIndex(firstNewPly).row();
+        if(firstRow < oldRows) {
+            emit dataChanged(index(firstRow, 0), index(oldRows - 1, 1));
+        }
+    }
+}
+
+QModelIndex MoveHistoryModel::getIndex(size_t ply) const {
+    size_t cell = ply + static_cast<size_t>(_offset);
+    return createIndex(static_cast<int>(cell / 2), static_cast<int>(cell % 2));
+}
+
+size_t MoveHistoryModel::getPly(const QModelIndex& index) const {
+    if(!index.isValid()) {
+        return static_cast<size_t>(-1);
+    }
+    int cell = index.row() * 2 + index.column() - _offset;
+    return cell < 0 ? static_cast<size_t>(-1) : static_cast<size_t>(cell);
+}
+
+int MoveHistoryModel::getRowCount(size_t noPlies) const {
+    if(noPlies == 0) {
+        return 0;
+    }
+    return static_cast<int>((noPlies + static_cast<size_t>(_offset) + 1) / 2);
+}
@@ -0,0 +1,328 @@
+#include "../include/chess/engine/opening_index.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace chess;
+
+namespace {
+
+using Entry = OpeningIndex::Entry;
+
+uint32_t getMoveKey(const Entry& entry) {
+    return static_cast<uint32_t>(entry.origin) << 16 | static_cast<uint32_t>(entry.destination) << 8 | entry.type;
+}
+
+bool isBefore(const Entry& entry, const Entry& other) {
+    return entry.hash < other.hash || (entry.hash == other.hash && getMoveKey(entry) < getMoveKey(other));
+}
+
+std::pair<short, short> toPosition(uint8_t square) {
+    return std::make_pair(static_cast<short>(square / 8), static_cast<short>(square % 8));
+}
+
+}
+
+const char OpeningIndex::Magic[4] = {'C', 'O', 'I', '1'};
+const size_t OpeningIndex::HeaderSize;
+
+OpeningMove::OpeningMove()
+    : move(), whiteWins(0), draws(0), blackWins(0) {}
+
+uint32_t OpeningMove::getNoGames() const {
+    return whiteWins + draws + blackWins;
+}
+
+OpeningIndex::OpeningIndex()
+    : _entries(nullptr), _noEntries(0), _mapping(nullptr), _mappingSize(0) {}
+
+OpeningIndex::~OpeningIndex() {
+    close();
+}
+
+void OpeningIndex::open(const std::string& filename) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Error: Couldn't open " + filename);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if(mapping) {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    _mappingSize = static_cast<size_t>(size.QuadPart);
+#else
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if(file < 0) {
+        throw std::runtime_error("Error: Couldn't open " + filename);
+    }
+    struct stat status;
+    fstat(file, &status);
+    void* data = status.st_size > 0 ? mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED;
+    ::close(file);
+    if(data == MAP_FAILED) {
+        data = nullptr;
+    }
+    _mappingSize = static_cast<size_t>(status.st_size);
+#endif
+    if(!data) {
+        _mappingSize = 0;
+        throw std::runtime_error("Error: Couldn't map " + filename);
+    }
+    _mapping = data;
+
+    const char* bytes = static_cast<const char*>(_mapping);
+    uint64_t noEntries = 0;
+    if(_mappingSize >= HeaderSize) {
+        std::memcpy(&noEntries, bytes + 8, sizeof(noEntries));
+    }
+    if(_mappingSize < HeaderSize || std::memcmp(bytes, Magic, sizeof(Magic)) != 0
+            || _mappingSize != HeaderSize + noEntries * sizeof(Entry)) {
+        close();
+        throw std::invalid_argument("Error: " + filename + " is not an opening index");
+    }
+    _entries = reinterpret_cast<const Entry*>(bytes + HeaderSize);
+    _noEntries = static_cast<size_t>(noEntries);
+}
+
+void OpeningIndex::close() {
+    if(_mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(_mapping);
+#else
+        munmap(_mapping, _mappingSize);
+#endif
+    }
+    _entries = nullptr;
+    _noEntries = 0;
+    _mapping = nullptr;
+    _mappingSize = 0;
+}
+
+bool OpeningIndex::isOpen() const {
+    return _mapping != nullptr;
+}
+
+size_t OpeningIndex::size() const {
+    return _noEntries;
+}
+
+std::vector<OpeningMove> OpeningIndex::find(const Game& game) const {
+    return find(game.getHash());
+}
+
+std::vector<OpeningMove> OpeningIndex::find(uint64_t hash) const {
+    std::vector<OpeningMove> moves;
+    const Entry* end = _entries + _noEntries;
+    const Entry* entry = std::lower_bound(_entries, end, hash, [](const Entry& entry, uint64_t hash) {
+        return entry.hash < hash;
+    });
+    for(; entry != end && entry->hash == hash; entry++) {
+        OpeningMove move;
+        move.move = Move(toPosition(entry->origin), toPosition(entry->destination), static_cast<MoveType>(entry->type));
+        move.whiteWins = entry->whiteWins;
+        move.draws = entry->draws;
+        move.blackWins = entry->blackWins;
+        moves.push_back(move);
+    }
+    std::stable_sort(moves.begin(), moves.end(), [](const OpeningMove& move, const OpeningMove& other) {
+        return move.getNoGames() > other.getNoGames();
+    });
+    return moves;
+}
+
+bool OpeningIndexBuilder::Key::operator==(const Key& other) const {
+    return hash == other.hash && move == other.move;
+}
+
+OpeningIndexBuilder::OpeningIndexBuilder(short maxPlies)
+    : _maxPlies(maxPlies), _mutex(), _partials() {}
+
+// Games without a result are left out, as they can't add to any count.
+void OpeningIndexBuilder::add(const ArchivedGame& game) {
+    if(game.result == GameState::Playing) {
+        return;
+    }
+    Partial& partial = getPartial();
+    auto visit = [&](const Game& position, const Move& move) {
+        count(partial, position, move, game.result);
+    };
+    if(game.moves.size() > static_cast<size_t>(_maxPlies)) {
+        ArchivedGame opening(game);
+        opening.moves.resize(_maxPlies);
+        opening.replay(visit);
+    } else {
+        game.replay(visit);
+    }
+    partial.noGames++;
+}
+
+void OpeningIndexBuilder::add(const Game& start, const std::vector<Move>& moves, GameState result) {
+    if(result == GameState::Playing) {
+        return;
+    }
+    Partial& partial = getPartial();
+    Game game(start);
+    size_t noPlies = std::min(moves.size(), static_cast<size_t>(_maxPlies));
+    for(size_t ply = 0; ply < noPlies; ply++) {
+        const Move& move = moves[ply];
+        count(partial, game, move, result);
+        game.move(move.origin, move.destination, move.type);
+    }
+    partial.noGames++;
+}
+
+size_t OpeningIndexBuilder::write(const std::string& filename, ThreadPool& pool, uint32_t minGames) {
+    std::vector<std::unique_ptr<Partial>> partials;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(auto& partial : _partials) {
+            partials.push_back(std::move(partial.second));
+        }
+        _partials.clear();
+    }
+
+    std::vector<std::vector<Entry>> sorted(partials.size());
+    for(size_t i = 0; i < partials.size(); i++) {
+        pool.submit([&, i]() {
+            auto& counts = partials[i]->counts;
+            std::vector<Entry>& entries = sorted[i];
+            entries.reserve(counts.size());
+            for(const auto& count : counts) {
+                Entry entry;
+                entry.hash = count.first.hash;
+                entry.origin = static_cast<uint8_t>(count.first.move);
+                entry.destination = static_cast<uint8_t>(count.first.move >> 8);
+                entry.type = static_cast<uint8_t>(count.first.move >> 16);
+                entry.reserved = 0;
+                entry.whiteWins = count.second.whiteWins;
+                entry.draws = count.second.draws;
+                entry.blackWins = count.second.blackWins;
+                entries.push_back(entry);
+            }
+            std::unordered_map<Key, Counts, KeyHash>().swap(counts);
+            std::sort(entries.begin(), entries.end(), isBefore);
+        });
+    }
+    pool.wait();
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file) {
+        throw std::runtime_error("Error: Couldn't open " + filename);
+    }
+    char header[OpeningIndex::HeaderSize] = {};
+    std::memcpy(header, OpeningIndex::Magic, sizeof(OpeningIndex::Magic));
+    file.write(header, sizeof(header));
+
+    // Merge the sorted tables, summing the counts of equal keys.
+    auto later = [&](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return isBefore(sorted[b.first][b.second], sorted[a.first][a.second]);
+    };
+    std::priority_queue<std::pair<size_t, size_t>, std::vector<std::pair<size_t, size_t>>, decltype(later)> heads(later);
+    for(size_t i = 0; i < sorted.size(); i++) {
+        if(!sorted[i].empty()) {
+            heads.push(std::make_pair(i, size_t(0)));
+        }
+    }
+    std::vector<Entry> buffer;
+    buffer.reserve(4096);
+    uint64_t noEntries = 0;
+    Entry merged = Entry();
+    bool hasMerged = false;
+    auto flush = [&]() {
+        if(hasMerged && merged.whiteWins + merged.draws + merged.blackWins >= minGames) {
+            buffer.push_back(merged);
+            noEntries++;
+            if(buffer.size() == buffer.capacity()) {
+                file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Entry)));
+                buffer.clear();
+            }
+        }
+    };
+    while(!heads.empty()) {
+        auto head = heads.top();
+        heads.pop();
+        const Entry& entry = sorted[head.first][head.second];
+        if(hasMerged && entry.hash == merged.hash && getMoveKey(entry) == getMoveKey(merged)) {
+            merged.whiteWins += entry.whiteWins;
+            merged.draws += entry.draws;
+            merged.blackWins += entry.blackWins;
+        } else {
+            flush();
+            merged = entry;
+            hasMerged = true;
+        }
+        if(++head.second < sorted[head.first].size()) {
+            heads.push(head);
+        }
+    }
+    flush();
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Entry)));
+    file.seekp(8);
+    file.write(reinterpret_cast<const char*>(&noEntries), sizeof(noEntries));
+    if(!file) {
+        throw std::runtime_error("Error: Couldn't write " + filename);
+    }
+    return static_cast<size_t>(noEntries);
+}
+
+size_t OpeningIndexBuilder::getNoGames() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t noGames = 0;
+    for(const auto& partial : _partials) {
+        noGames += partial.second->noGames;
+    }
+    return noGames;
+}
+
+size_t OpeningIndexBuilder::getNoPlies() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t noPlies = 0;
+    for(const auto& partial : _partials) {
+        noPlies += partial.second->noPlies;
+    }
+    return noPlies;
+}
+
+OpeningIndexBuilder::Partial& OpeningIndexBuilder::getPartial() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_ptr<Partial>& partial = _partials[std::this_thread::get_id()];
+    if(!partial) {
+        partial.reset(new Partial());
+    }
+    return *partial;
+}
+
+void OpeningIndexBuilder::count(Partial& partial, const Game& position, const Move& move, GameState result) {
+    Key key;
+    key.hash = position.getHash();
+    key.move = static_cast<uint32_t>(move.origin.first * 8 + move.origin.second)
+            | static_cast<uint32_t>(move.destination.first * 8 + move.destination.second) << 8
+            | static_cast<uint32_t>(move.type) << 16;
+    Counts& counts = partial.counts[key];
+    if(result == GameState::WhiteWin) {
+        counts.whiteWins++;
+    } else if(result == GameState::BlackWin) {
+        counts.blackWins++;
+    } else {
+        counts.draws++;
+    }
+    partial.noPlies++;
+}
@@ -0,0 +1,232 @@
+#include "../include/chess/engine/packed_position.hpp"
+#include "../include/chess/engine/zobrist.hpp"
+#include <cstring>
+
+using namespace chess;
+
+const uint8_t PackedPosition::EnPassantPawn;
+const uint8_t PackedPosition::BlackToMove;
+const uint8_t PackedPosition::WhiteCastleA;
+const uint8_t PackedPosition::WhiteCastleH;
+const uint8_t PackedPosition::BlackCastleA;
+const uint8_t PackedPosition::BlackCastleH;
+
+PackedPosition::PackedPosition()
+    : _squares(), _state(0) {}
+
+PackedPosition::PackedPosition(const Game& game)
+    : _squares(), _state(0) {
+    const Board& board = game.getBoard();
+    for(short square = 0; square < 64; square++) {
+        Piece piece = board.getSquare(square).piece;
+        if(piece.type != PieceType::None) {
+            setCode(square, static_cast<uint8_t>(static_cast<uint8_t>(piece.type) | (piece.color == PieceColor::Black ? 8 : 0)));
+        }
+    }
+    short enPassantPawn = game.getEnPassantPawn();
+    if(enPassantPawn >= 0) {
+        setCode(enPassantPawn, EnPassantPawn);
+    }
+    if(game.getTurn() == PieceColor::Black) {
+        _state |= BlackToMove;
+    }
+    if(game.canWhiteCastleA()) {
+        _state |= WhiteCastleA;
+    }
+    if(game.canWhiteCastleH()) {
+        _state |= WhiteCastleH;
+    }
+    if(game.canBlackCastleA()) {
+        _state |= BlackCastleA;
+    }
+    if(game.canBlackCastleH()) {
+        _state |= BlackCastleH;
+    }
+}
+
+bool PackedPosition::isValid() const {
+    if(_state >= BlackCastleH << 1) {
+        return false;
+    }
+    short counts[2][7] = {};
+    short noEnPassantPawns = 0;
+    for(short square = 0; square < 64; square++) {
+        uint8_t code = getCode(square);
+        if(code == EnPassantPawn) {
+            short rank = getTurn() == PieceColor::White ? 4 : 3;
+            if(square % 8 != rank || ++noEnPassantPawns > 1) {
+                return false;
+            }
+            counts[getTurn() == PieceColor::White ? 1 : 0][static_cast<size_t>(PieceType::Pawn)]++;
+        } else if(code == 8 || code == 15) {
+            return false;
+        } else if(code != 0) {
+            counts[code >> 3][code & 7]++;
+        }
+    }
+    // The same limits as a FEN, so the material counts of Game can't overflow.
+    for(const auto& count : counts) {
+        if(count[static_cast<size_t>(PieceType::King)] != 1) {
+            return false;
+        }
+        for(size_t type = static_cast<size_t>(PieceType::Knight); type <= static_cast<size_t>(PieceType::Queen); type++) {
+            if(count[type] + count[static_cast<size_t>(PieceType::Pawn)] > 15) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Game PackedPosition::unpack(short noHalfMoves, short noMoves) const {
+    static const Game empty("8/8/8/8/8/8/8/8 w - -");
+    Game game(empty);
+    PieceColor enPassantColor = getTurn() == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    for(short square = 0; square < 64; square++) {
+        uint8_t code = getCode(square);
+        if(code == 0) {
+            continue;
+        }
+        Piece& piece = game._board.getSquare(square).piece;
+        if(code == EnPassantPawn) {
+            piece.type = PieceType::Pawn;
+            piece.color = enPassantColor;
+            game._enPassantSquare = &game._board.getSquare(square + (enPassantColor == PieceColor::Black ? 1 : -1));
+        } else {
+            piece.type = static_cast<PieceType>(code & 7);
+            piece.color = code & 8 ? PieceColor::Black : PieceColor::White;
+        }
+        size_t colorIndex = piece.color == PieceColor::White ? 0 : 1;
+        game._materialKey += uint64_t(1) << (4 * (colorIndex * 6 + static_cast<size_t>(piece.type) - 1));
+        if(piece.type == PieceType::King) {
+            if(piece.color == PieceColor::White) {
+                game._whiteKingSquare = &game._board.getSquare(square);
+            } else {
+                game._blackKingSquare = &game._board.getSquare(square);
+            }
+        }
+    }
+    game._turn = getTurn();
+    game._whiteCastleA = canWhiteCastleA();
+    game._whiteCastleH = canWhiteCastleH();
+    game._blackCastleA = canBlackCastleA();
+    game._blackCastleH = canBlackCastleH();
+    game._noHalfMoves = noHalfMoves;
+    game._noMoves = noMoves;
+    return game;
+}
+
+Piece PackedPosition::getPiece(short square) const {
+    uint8_t code = getCode(square);
+    Piece piece;
+    if(code == EnPassantPawn) {
+        piece.type = PieceType::Pawn;
+        piece.color = getTurn() == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    } else if(code != 0) {
+        piece.type = static_cast<PieceType>(code & 7);
+        piece.color = code & 8 ? PieceColor::Black : PieceColor::White;
+    }
+    return piece;
+}
+
+uint64_t PackedPosition::getOccupied() const {
+    uint64_t occupied = 0;
+    for(short i = 0; i < 32; i++) {
+        uint8_t byte = _squares[i];
+        if(byte & 0x0f) {
+            occupied |= uint64_t(1) << (2 * i);
+        }
+        if(byte & 0xf0) {
+            occupied |= uint64_t(1) << (2 * i + 1);
+        }
+    }
+    return occupied;
+}
+
+PieceColor PackedPosition::getTurn() const {
+    return _state & BlackToMove ? PieceColor::Black : PieceColor::White;
+}
+
+short PackedPosition::getEnPassantSquare() const {
+    for(short i = 0; i < 32; i++) {
+        uint8_t byte = _squares[i];
+        short square = -1;
+        if((byte & 0x0f) == EnPassantPawn) {
+            square = 2 * i;
+        } else if((byte >> 4) == EnPassantPawn) {
+            square = 2 * i + 1;
+        }
+        if(square >= 0) {
+            return square + (getTurn() == PieceColor::White ? 1 : -1);
+        }
+    }
+    return -1;
+}
+
+bool PackedPosition::canWhiteCastleA() const {
+    return _state & WhiteCastleA;
+}
+
+bool PackedPosition::canWhiteCastleH() const {
+    return _state & WhiteCastleH;
+}
+
+bool PackedPosition::canBlackCastleA() const {
+    return _state & BlackCastleA;
+}
+
+bool PackedPosition::canBlackCastleH() const {
+    return _state & BlackCastleH;
+}
+
+uint64_t PackedPosition::getHash() const {
+    const zobrist::Keys& keys = zobrist::keys;
+    uint64_t hash = 0;
+    for(short square = 0; square < 64; square++) {
+        uint8_t code = getCode(square);
+        if(code == EnPassantPawn) {
+            size_t color = getTurn() == PieceColor::White ? 1 : 0;
+            hash ^= keys.pieces[color][static_cast<size_t>(PieceType::Pawn) - 1][square];
+            hash ^= keys.enPassant[square / 8];
+        } else if(code != 0) {
+            hash ^= keys.pieces[code >> 3][(code & 7) - 1][square];
+        }
+    }
+    const uint8_t castling[] = {WhiteCastleA, WhiteCastleH, BlackCastleA, BlackCastleH};
+    for(short i = 0; i < 4; i++) {
+        if(_state & castling[i]) {
+            hash ^= keys.castling[i];
+        }
+    }
+    if(_state & BlackToMove) {
+        hash ^= keys.blackToMove;
+    }
+    return hash;
+}
+
+bool PackedPosition::operator==(const PackedPosition& other) const {
+    return _state == other._state && _squares == other._squares;
+}
+
+bool PackedPosition::operator!=(const PackedPosition& other) const {
+    return !(*this == other);
+}
+
+bool PackedPosition::operator<(const PackedPosition& other) const {
+    int order = std::memcmp(_squares.data(), other._squares.data(), _squares.size());
+    return order < 0 || (order == 0 && _state < other._state);
+}
+
+uint8_t PackedPosition::getCode(short square) const {
+    uint8_t byte = _squares[square / 2];
+    return square % 2 ? byte >> 4 : byte & 0xf;
+}
+
+void PackedPosition::setCode(short square, uint8_t code) {
+    uint8_t& byte = _squares[square / 2];
+    if(square % 2) {
+        byte = static_cast<uint8_t>((byte & 0x0f) | (code << 4));
+    } else {
+        byte = static_cast<uint8_t>((byte & 0xf0) | code);
+    }
+}
@@ -35,7 +35,7 @@ Piece::Piece(char piece) {
 	}
 }
 
-bool Piece::operator!=(const Piece other) {
+bool Piece::operator!=(const Piece other) const {
     if(type != other.type) {
         return true;
     }
@@ -45,11 +45,11 @@ bool Piece::operator!=(const Piece other) {
     return false;
 }
 
-bool Piece::operator==(const Piece other) {
+bool Piece::operator==(const Piece other) const {
     return !(*this != other);
 }
 
-Piece::operator char() {
+Piece::operator char() const {
     char c;
     switch(type) {
     case PieceType::King:
@@ -0,0 +1,57 @@
+#include "../include/chess/piece_cache.hpp"
+#include <QPainter>
+#include <algorithm>
+
+using namespace chess;
+
+PieceCache::PieceCache()
+    : _entries() {}
+
+void PieceCache::load(const QString& directory) {
+    char pieceColor[] = "LD";
+    char pieceType[] = "PNBRQK";
+
+    for(short colorNo = 0; colorNo < 2; colorNo++) {
+        for(short typeNo = 0; typeNo < 6; typeNo++) {
+            QString filename = directory + "/" + QString(pieceType[typeNo]) + QString(pieceColor[colorNo]) + ".svg";
+            _renderers[colorNo][typeNo].reset(new QSvgRenderer(filename));
+        }
+    }
+    _entries.clear();
+}
+
+QPixmap PieceCache::getPixmap(Piece piece, int size, qreal devicePixelRatio) {
+    if(piece.type == PieceType::None || size <= 0) {
+        return QPixmap();
+    }
+    int pixelSize = qRound(size * devicePixelRatio);
+    auto entry = _entries.begin();
+    while(entry != _entries.end() && entry->size != pixelSize) {
+        ++entry;
+    }
+    if(entry == _entries.end()) {
+        if(_entries.size() >= MaxSizes) {
+            _entries.pop_back();
+        }
+        _entries.insert(_entries.begin(), Entry{pixelSize, {}});
+    } else if(entry != _entries.begin()) {
+        std::rotate(_entries.begin(), entry, entry + 1);
+    }
+    size_t colorNo = Piece::colorIndex(piece.color);
+    size_t typeNo = static_cast<size_t>(piece.type) - 1;
+    if(_entries.front().pixmaps[colorNo][typeNo].isNull()) {
+        render(_entries.front(), colorNo, typeNo, devicePixelRatio);
+    }
+    return _entries.front().pixmaps[colorNo][typeNo];
+}
+
+void PieceCache::render(Entry& entry, size_t colorNo, size_t typeNo, qreal devicePixelRatio) {
+    QPixmap pixmap(entry.size, entry.size);
+    pixmap.fill(Qt::transparent);
+    if(_renderers[colorNo][typeNo]) {
+        QPainter painter(&pixmap);
+        _renderers[colorNo][typeNo]->render(&painter);
+    }
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    entry.pixmaps[colorNo][typeNo] = pixmap;
+}
@@ -1,11 +1,12 @@
 #include "../include/chess/engine/pressure_factory.hpp"
-#define _USE_MATH_DEFINES
-#include <math.h>
+#include "../include/chess/engine/stats.hpp"
 
 using namespace chess;
 
-PressureFactory::PressureFactory(Board board, const std::pair<short, short>& piecePosition)
-	: _board(board), _selectedSquare(_board[piecePosition]), _moves() {
+PressureFactory::PressureFactory(const Board& board, const std::pair<short, short>& piecePosition,
+		std::pmr::memory_resource* resource)
+	: _board(board), _selectedSquare(_board[piecePosition]), _moves(resource) {
+	CHESS_STATS_TIME(PressureFactories);
 	generateMoves();
 }
 
@@ -13,7 +14,7 @@ bool PressureFactory::canAttack(const std::pair<short, short> destination) {
 	return _moves.find(destination) != _moves.end();
 }
 
-std::unordered_map<std::pair<short, short>, MoveType, PairHash> PressureFactory::getMoves() {
+const std::pmr::unordered_map<std::pair<short, short>, MoveType, PairHash>& PressureFactory::getMoves() const {
 	return _moves;
 }
 
@@ -21,24 +22,19 @@ void PressureFactory::generateMoves() {
 	_moves.clear();
 	switch(_selectedSquare.piece.type) {
 	case PieceType::King:
-		generateVerticalMoves();
-		generateHorizontalMoves();
-		generateDiagonalMoves();
+		generateJumpMoves(kingTargets);
 		break;
 	case PieceType::Queen:
-		generateVerticalMoves(true);
-		generateHorizontalMoves(true);
-		generateDiagonalMoves(true);
+		generateRayMoves(Direction::North, Direction::NorthWest);
 		break;
 	case PieceType::Rook:
-		generateHorizontalMoves(true);
-		generateVerticalMoves(true);
+		generateRayMoves(Direction::North, Direction::West);
 		break;
 	case PieceType::Bishop:
-		generateDiagonalMoves(true);
+		generateRayMoves(Direction::NorthEast, Direction::NorthWest);
 		break;
 	case PieceType::Knight:
-		generateJumpMoves();
+		generateJumpMoves(knightTargets);
 		break;
 	case PieceType::Pawn: {
 		short x = _selectedSquare.getX();
@@ -54,110 +50,33 @@ void PressureFactory::generateMoves() {
 	}
 }
 
-void PressureFactory::generateVerticalMoves(bool multiMove) {
-	short _x = _selectedSquare.getX();
-	short _y = _selectedSquare.getY();
-	short minDistanceY, maxDistanceY;
-	if(multiMove) {
-		minDistanceY = 0;
-		maxDistanceY = 7;
-	} else {
-		minDistanceY = _y - 1;
-		maxDistanceY = _y + 1;
-		minDistanceY = minDistanceY > 0 ? minDistanceY : 0;
-		maxDistanceY = maxDistanceY < 7 ? maxDistanceY : 7;
-	}
-	for(short y = _y + 1; y <= maxDistanceY; y++) {
-		if(!addMove(_x, y)) {
-			break;
-		}
-	}
-	for(short y = _y - 1; y >= minDistanceY; y--) {
-		if(!addMove(_x, y)) {
-			break;
-		}
-	}
-}
-void PressureFactory::generateHorizontalMoves(bool multiMove) {
-	short _x = _selectedSquare.getX();
-	short _y = _selectedSquare.getY();
-	short minDistanceX, maxDistanceX;
-	if(multiMove) {
-		minDistanceX = 0;
-		maxDistanceX = 7;
-	} else {
-		minDistanceX = _x - 1;
-		maxDistanceX = _x + 1;
-		minDistanceX = minDistanceX > 0 ? minDistanceX : 0;
-		maxDistanceX = maxDistanceX < 7 ? maxDistanceX : 7;
-	}
-	for(short x = _x + 1; x <= maxDistanceX; x++) {
-		if(!addMove(x, _y)) {
-			break;
-		}
-	}
-	for(short x = _x - 1; x >= minDistanceX; x--) {
-		if(!addMove(x, _y)) {
-			break;
+void PressureFactory::generateRayMoves(Direction first, Direction last) {
+	const auto& squareRays = rays[_selectedSquare.getX() * 8 + _selectedSquare.getY()];
+	for(short direction = static_cast<short>(first); direction <= static_cast<short>(last); direction++) {
+		for(uint8_t square : squareRays[direction]) {
+			if(!addMove(square)) {
+				break;
+			}
 		}
 	}
 }
-void PressureFactory::generateDiagonalMoves(bool multiMove) {
-	short _x = _selectedSquare.getX();
-	short _y = _selectedSquare.getY();
-	short x, y;
-	short minDistanceX, minDistanceY;
-	short maxDistanceX, maxDistanceY;
-	if(multiMove) {
-		minDistanceX = minDistanceY = 0;
-		maxDistanceX = maxDistanceY = 7;
-	} else {
-		minDistanceX = _x - 1;
-		minDistanceY = _y - 1;
-		maxDistanceX = _x + 1;
-		maxDistanceY = _y + 1;
-		minDistanceX = minDistanceX > 0 ? minDistanceX : 0;
-		minDistanceY = minDistanceY > 0 ? minDistanceY : 0;
-		maxDistanceX = maxDistanceX < 7 ? maxDistanceX : 7;
-		maxDistanceY = maxDistanceY < 7 ? maxDistanceY : 7;
-	}
-	for(x = _x + 1, y = _y + 1; x <= maxDistanceX && y <= maxDistanceY; x++, y++) {
-		if(!addMove(x, y)) {
-		break;
-		}
-	}
-	for(x = _x + 1, y = _y - 1; x <= maxDistanceX && y >= minDistanceY; x++, y--) {
-		if(!addMove(x, y)) {
-		break;
-		}
-	}
-	for(x = _x - 1, y = _y - 1; x >= minDistanceX && y >= minDistanceY; x--, y--) {
-	if(!addMove(x, y)) {
-			break;
-		}
-	}
-	for(x = _x - 1, y = _y + 1; x >= minDistanceX && y <= maxDistanceY; x--, y++) {
-		if(!addMove(x, y)) {
-			break;
-		}
+
+void PressureFactory::generateJumpMoves(const std::array<SquareList, 64>& targets) {
+	for(uint8_t square : targets[_selectedSquare.getX() * 8 + _selectedSquare.getY()]) {
+		addMove(square);
 	}
 }
 
-void PressureFactory::generateJumpMoves() {
-	short _x = _selectedSquare.getX();
-	short _y = _selectedSquare.getY();
-	for(short i = 0; i < 4; i++) {
-		for(short j = -1; j <= 1; j += 2) {
-			short x = static_cast<short>(2 * sin(i * M_PI_2)) + _x;
-			short y = static_cast<short>(2 * cos(i * M_PI_2)) + _y;
-			if(i % 2) {
-				y += j;
-			} else {
-				x += j;
-			}
-			addMove(x, y);
+bool PressureFactory::addMove(short index) {
+	const Square& destination = _board.getSquare(index);
+	if(destination.piece.type != PieceType::None) {
+		if(destination.piece.color != _selectedSquare.piece.color) {
+			_moves.insert(std::make_pair(destination.getPosition(), MoveType::Normal));
 		}
+		return false;
 	}
+	_moves.insert(std::make_pair(destination.getPosition(), MoveType::Normal));
+	return true;
 }
 
 bool PressureFactory::addMove(short x, short y, MoveType moveType) {
@@ -0,0 +1,94 @@
+#include "../include/chess/engine/rules.hpp"
+#include "../include/chess/engine/arena.hpp"
+#include "../include/chess/engine/move_generator.hpp"
+#include <algorithm>
+
+using namespace chess;
+
+namespace {
+
+const int pieceValues[] = {0, 100, 320, 330, 500, 900, 0};
+
+}
+
+std::pmr::vector<Move> rules::legalMoves(const Game& game, std::pmr::memory_resource* resource) {
+    return MoveGenerator(game).getLegalMoves(resource);
+}
+
+bool rules::hasLegalMoves(const Game& game) {
+    return MoveGenerator(game).hasLegalMoves();
+}
+
+Move rules::findMove(const Game& game, const std::pair<short, short>& origin, const std::pair<short, short>& destination) {
+    Arena::Scope scope(Arena::local());
+    auto moves = legalMoves(game, &Arena::local());
+    auto move = std::find_if(moves.begin(), moves.end(), [&](const Move& move) {
+        return move.origin == origin && move.destination == destination;
+    });
+    return move != moves.end() ? *move : Move();
+}
+
+bool rules::isCheck(const Game& game, PieceColor color) {
+    const Square* king = color == PieceColor::White ? game.getWhiteKingSquare() : game.getBlackKingSquare();
+    if(!king) {
+        return false;
+    }
+    PieceColor enemy = color == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    return MoveGenerator(game).getAttackers(king->getX() * 8 + king->getY(), enemy) != 0;
+}
+
+int rules::see(const Game& game, const Move& move) {
+    return MoveGenerator(game).see(move);
+}
+
+int rules::pieceValue(PieceType type) {
+    return pieceValues[static_cast<size_t>(type)];
+}
+
+bool rules::isInsufficientMaterial(const Game& game) {
+    short noPieces = 0;
+    short noBishops = 0;
+    short noKnights = 0;
+    for(PieceColor color : {PieceColor::White, PieceColor::Black}) {
+        for(short type = static_cast<short>(PieceType::Pawn); type < static_cast<short>(PieceType::King); type++) {
+            noPieces += game.getPieceCount(color, static_cast<PieceType>(type));
+        }
+        noBishops += game.getPieceCount(color, PieceType::Bishop);
+        noKnights += game.getPieceCount(color, PieceType::Knight);
+    }
+    if(noPieces == 0) {
+        return true;
+    }
+    if(noPieces == 1) {
+        return noBishops == 1 || noKnights == 1;
+    }
+    if(noPieces == 2 && noBishops == 2) {
+        short squareColors[2];
+        short noFound = 0;
+        for(short index = 0; index < 64; index++) {
+            const Square& square = game.getBoard().getSquare(index);
+            if(square.piece.type == PieceType::Bishop) {
+                squareColors[noFound++] = (square.getX() + square.getY()) % 2;
+            }
+        }
+        return squareColors[0] == squareColors[1];
+    }
+    return false;
+}
+
+GameState rules::gameState(const Game& game, short noRepetitions) {
+    if(noRepetitions >= 3) {
+        return GameState::Draw;
+    }
+    MoveGenerator generator(game);
+    if(generator.hasLegalMoves()) {
+        if(game.getNoHalfMoves() >= 100 || isInsufficientMaterial(game)) {
+            return GameState::Draw;
+        }
+        return GameState::Playing;
+    }
+    if(!generator.isCheck()) {
+        return GameState::Draw;
+    }
+    return game.getTurn() == PieceColor::White ? GameState::BlackWin : GameState::WhiteWin;
+}
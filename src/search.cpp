@@ -0,0 +1,195 @@
+#include "../include/chess/engine/search.hpp"
+#include "../include/chess/engine/arena.hpp"
+#include "../include/chess/engine/move_generator.hpp"
+#include "../include/chess/engine/rules.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace chess;
+
+namespace {
+
+int centralization(short x, short y) {
+    return 7 - std::abs(2 * x - 7) / 2 - std::abs(2 * y - 7) / 2;
+}
+
+}
+
+SearchLimits::SearchLimits()
+    : depth(0), nodes(0), time(0), stop(nullptr) {}
+
+SearchResult::SearchResult()
+    : bestMove(), score(0), depth(0), principalVariation(), nodes(0) {}
+
+bool SearchResult::isMate() const {
+    return std::abs(score) > Search::MateScore - Search::MaxDepth;
+}
+
+short SearchResult::getMateDistance() const {
+    if(!isMate()) {
+        return 0;
+    }
+    short plies = static_cast<short>(Search::MateScore - std::abs(score));
+    short moves = static_cast<short>((plies + 1) / 2);
+    return score > 0 ? moves : -moves;
+}
+
+Search::Search(const Game& game)
+    : _game(game), _limits(), _nodes(0), _aborted(false), _start(), _previousPv() {}
+
+SearchResult Search::run(const SearchLimits& limits, const Listener& listener) {
+    _limits = limits;
+    _nodes = 0;
+    _aborted = false;
+    _start = std::chrono::steady_clock::now();
+    _previousPv.clear();
+
+    short maxDepth = _limits.depth;
+    if(maxDepth <= 0 || maxDepth > MaxDepth) {
+        maxDepth = _limits.nodes || _limits.time.count() || _limits.stop ? MaxDepth : 1;
+    }
+
+    SearchResult result;
+    for(short depth = 1; depth <= maxDepth; depth++) {
+        Arena::Scope scope(Arena::local());
+        std::pmr::vector<Move> pv(&Arena::local());
+        pv.reserve(MaxDepth + 1);
+        int score = negamax(_game, depth, 0, -MateScore - 1, MateScore + 1, pv);
+        if(_aborted && result.depth > 0) {
+            break;
+        }
+        result.score = score;
+        result.depth = depth;
+        result.principalVariation.assign(pv.begin(), pv.end());
+        result.bestMove = pv.empty() ? Move() : pv.front();
+        _previousPv.assign(pv.begin(), pv.end());
+        if(listener && !_aborted) {
+            result.nodes = _nodes;
+            listener(result);
+        }
+        if(_aborted || pv.empty() || result.isMate()) {
+            break;
+        }
+    }
+    result.nodes = _nodes;
+    return result;
+}
+
+int Search::negamax(const Game& game, short depth, short ply, int alpha, int beta, std::pmr::vector<Move>& pv) {
+    pv.clear();
+    if(shouldAbort()) {
+        _aborted = true;
+        return 0;
+    }
+    _nodes++;
+
+    if(depth == 0) {
+        return evaluate(game);
+    }
+    if(ply > 0 && game.getNoHalfMoves() >= 100) {
+        return 0;
+    }
+
+    Arena::Scope scope(Arena::local());
+    MoveGenerator generator(game);
+    auto moves = generator.getLegalMoves(&Arena::local());
+    if(moves.empty()) {
+        return generator.isCheck() ? -MateScore + ply : 0;
+    }
+    orderMoves(game, depth > 1 ? &generator : nullptr, moves, ply == 0 && !_previousPv.empty() ? _previousPv.front() : Move());
+
+    std::pmr::vector<Move> childPv(&Arena::local());
+    childPv.reserve(MaxDepth + 1);
+    for(const auto& move : moves) {
+        Game child(game);
+        child.move(move.origin, move.destination, move.type);
+        int score = -negamax(child, depth - 1, ply + 1, -beta, -alpha, childPv);
+        if(_aborted) {
+            return alpha;
+        }
+        if(score > alpha) {
+            alpha = score;
+            pv.clear();
+            pv.push_back(move);
+            pv.insert(pv.end(), childPv.begin(), childPv.end());
+            if(alpha >= beta) {
+                break;
+            }
+        }
+    }
+    return alpha;
+}
+
+bool Search::shouldAbort() {
+    if(_aborted) {
+        return true;
+    }
+    if(_limits.stop && _limits.stop->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if(_limits.nodes && _nodes >= _limits.nodes) {
+        return true;
+    }
+    if(_limits.time.count() && (_nodes & 63) == 0) {
+        return std::chrono::steady_clock::now() - _start >= _limits.time;
+    }
+    return false;
+}
+
+int Search::evaluate(const Game& game) {
+    const auto& board = game.getBoard();
+    int score = 0;
+    for(short x = 0; x < 8; x++) {
+        for(short y = 0; y < 8; y++) {
+            Piece piece = board[x][y].piece;
+            if(piece.type == PieceType::None) {
+                continue;
+            }
+            int value = rules::pieceValue(piece.type);
+            if(piece.type != PieceType::Rook && piece.type != PieceType::Queen) {
+                value += 2 * centralization(x, y);
+            }
+            score += piece.color == PieceColor::White ? value : -value;
+        }
+    }
+    return game.getTurn() == PieceColor::White ? score : -score;
+}
+
+// The move from the previous iteration comes first, then captures, most
+// valuable victim first, then quiet moves. Given a generator, captures that
+// lose material by static exchange go after the quiet moves; the search has
+// no quiescence, so one ply from the horizon every capture is left in front.
+void Search::orderMoves(const Game& game, const MoveGenerator* generator, std::pmr::vector<Move>& moves, const Move& bestMove) {
+    const auto& board = game.getBoard();
+    auto moveScore = [&](const Move& move) {
+        if(move == bestMove) {
+            return 1000000;
+        }
+        int captured = rules::pieceValue(board[move.destination].piece.type);
+        if(move.type == MoveType::EnPassantCapture) {
+            captured = rules::pieceValue(PieceType::Pawn);
+        }
+        if(move.type == MoveType::Promotion) {
+            captured += rules::pieceValue(PieceType::Queen);
+        }
+        if(captured == 0) {
+            return 0;
+        }
+        int exchange = generator ? generator->see(move) : 0;
+        if(exchange < 0) {
+            return exchange;
+        }
+        return 10 * captured - rules::pieceValue(board[move.origin].piece.type) / 10;
+    };
+    std::pmr::vector<std::pair<int, Move>> scored(&Arena::local());
+    scored.reserve(moves.size());
+    for(const auto& move : moves) {
+        scored.emplace_back(moveScore(move), move);
+    }
+    std::stable_sort(scored.begin(), scored.end(), [](const std::pair<int, Move>& a, const std::pair<int, Move>& b) {
+        return a.first > b.first;
+    });
+    for(size_t i = 0; i < moves.size(); i++) {
+        moves[i] = scored[i].second;
+    }
+}
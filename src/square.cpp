@@ -6,6 +6,9 @@
 
 using namespace chess;
 
+Square::Square()
+	: Square(0, 0) {}
+
 Square::Square(const short& x, const short& y)
 	: _x(x), _y(y), piece() { }
 
@@ -15,19 +18,19 @@ Square::Square(const std::pair<short, short>& position)
 Square::Square(const std::string& position) 
 	: Square(convertPosition(position)) {}
 
-Square::operator std::string() {
+Square::operator std::string() const {
 	return convertPosition(getPosition());
 }
 
-short Square::getX() {
+short Square::getX() const {
 	return _x;
 }
 
-short Square::getY() {
+short Square::getY() const {
 	return _y;
 }
 
-std::pair<short, short> Square::getPosition() {
+std::pair<short, short> Square::getPosition() const {
 	return std::make_pair(_x, _y);
 }
 
@@ -63,6 +66,6 @@ char Square::getRank(const std::pair<short, short>& position) {
     return '1' + static_cast<char>(position.second);
 }
 
-std::ostream& chess::operator<<(std::ostream& os, Square square) {
+std::ostream& chess::operator<<(std::ostream& os, const Square& square) {
 	return os << static_cast<std::string>(square);
 }
@@ -0,0 +1,98 @@
+#include "../include/chess/engine/stats.hpp"
+#include <atomic>
+#include <iomanip>
+
+using namespace chess;
+
+namespace {
+
+const size_t noCounters = static_cast<size_t>(StatsCounter::Count);
+
+std::atomic<uint64_t> counts[noCounters];
+std::atomic<uint64_t> nanoseconds[noCounters];
+
+}
+
+Stats::Stats()
+    : _entries() {}
+
+const StatsEntry& Stats::operator[](StatsCounter counter) const {
+    return _entries[static_cast<size_t>(counter)];
+}
+
+void Stats::print(std::ostream& os) const {
+    if(!isEnabled()) {
+        os << "Statistics are disabled, rebuild the engine with CHESS_STATS defined.\n";
+        return;
+    }
+    os << std::left << std::setw(20) << "counter"
+       << std::right << std::setw(14) << "count"
+       << std::setw(14) << "total ms"
+       << std::setw(12) << "avg ns" << "\n";
+    for(size_t i = 0; i < noCounters; i++) {
+        const StatsEntry& entry = _entries[i];
+        os << std::left << std::setw(20) << getName(static_cast<StatsCounter>(i))
+           << std::right << std::setw(14) << entry.count
+           << std::setw(14) << std::fixed << std::setprecision(3) << entry.nanoseconds / 1e6
+           << std::setw(12) << std::setprecision(1) << (entry.count ? static_cast<double>(entry.nanoseconds) / entry.count : 0.0)
+           << std::defaultfloat << "\n";
+    }
+}
+
+bool Stats::isEnabled() {
+#ifdef CHESS_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Stats Stats::snapshot() {
+    Stats stats;
+    for(size_t i = 0; i < noCounters; i++) {
+        stats._entries[i].count = counts[i].load(std::memory_order_relaxed);
+        stats._entries[i].nanoseconds = nanoseconds[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void Stats::reset() {
+    for(size_t i = 0; i < noCounters; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+        nanoseconds[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Stats::record(StatsCounter counter, std::chrono::nanoseconds elapsed) {
+    size_t index = static_cast<size_t>(counter);
+    counts[index].fetch_add(1, std::memory_order_relaxed);
+    nanoseconds[index].fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+}
+
+const char* Stats::getName(StatsCounter counter) {
+    switch(counter) {
+    case StatsCounter::GameCopies:
+        return "GameCopies";
+    case StatsCounter::BoardCopies:
+        return "BoardCopies";
+    case StatsCounter::PressureFactories:
+        return "PressureFactories";
+    case StatsCounter::EnemyCanAttack:
+        return "EnemyCanAttack";
+    case StatsCounter::SetGameState:
+        return "SetGameState";
+    case StatsCounter::MoveGeneration:
+        return "MoveGeneration";
+    case StatsCounter::GetAttackers:
+        return "GetAttackers";
+    default:
+        return "";
+    }
+}
+
+StatsTimer::StatsTimer(StatsCounter counter)
+    : _counter(counter), _start(std::chrono::steady_clock::now()) {}
+
+StatsTimer::~StatsTimer() {
+    Stats::record(_counter, std::chrono::steady_clock::now() - _start);
+}
@@ -0,0 +1,112 @@
+#include "../include/chess/engine/thread_pool.hpp"
+
+using namespace chess;
+
+namespace {
+
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+
+}
+
+ThreadPool::ThreadPool(size_t noThreads)
+    : _queues(), _threads(), _queued(0), _pending(0), _nextQueue(0), _stopping(false) {
+    if(noThreads == 0) {
+        noThreads = defaultSize();
+    }
+    for(size_t i = 0; i < noThreads; i++) {
+        _queues.emplace_back(new Queue());
+    }
+    for(size_t i = 0; i < noThreads; i++) {
+        _threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _taskAvailable.notify_all();
+    for(auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        index = currentPool == this ? currentIndex : _nextQueue++ % _queues.size();
+        _queued++;
+        _pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+        _queues[index]->tasks.push_back(std::move(task));
+    }
+    _taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]{ return _pending == 0; });
+}
+
+size_t ThreadPool::size() const {
+    return _threads.size();
+}
+
+size_t ThreadPool::defaultSize() {
+    size_t noThreads = std::thread::hardware_concurrency();
+    return noThreads ? noThreads : 1;
+}
+
+void ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while(true) {
+        std::function<void()> task;
+        if(popTask(index, task) || stealTask(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _queued--;
+            }
+            task();
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(--_pending == 0) {
+                _idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _taskAvailable.wait(lock, [this]{ return _stopping || _queued > 0; });
+        if(_stopping && _queued == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popTask(size_t index, std::function<void()>& task) {
+    Queue& queue = *_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t index, std::function<void()>& task) {
+    for(size_t i = 1; i < _queues.size(); i++) {
+        Queue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
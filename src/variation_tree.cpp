@@ -0,0 +1,138 @@
+#include "../include/chess/engine/variation_tree.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace chess;
+
+const uint32_t VariationTree::NoNode;
+const uint32_t VariationTree::Root;
+const short VariationTree::CheckpointInterval;
+const size_t VariationTree::MaxNotationLength;
+
+VariationTree::VariationTree(const Game& game)
+    : _nodes(), _checkpoints() {
+    reset(game);
+}
+
+void VariationTree::reset(const Game& game) {
+    _nodes.clear();
+    _checkpoints.clear();
+    _checkpoints.push_back(game);
+    const Game& root = _checkpoints.back();
+    _nodes.push_back(Node{
+        root.getHash(), NoNode, NoNode, NoNode, NoNode, 0, 0, 0, 0,
+        static_cast<uint8_t>(MoveType::None), static_cast<uint8_t>(root.getGameState()), {}
+    });
+}
+
+uint32_t VariationTree::findChild(uint32_t parent, const Move& move) const {
+    for(uint32_t child = _nodes[parent].firstChild; child != NoNode; child = _nodes[child].nextSibling) {
+        if(getMove(child) == move) {
+            return child;
+        }
+    }
+    return NoNode;
+}
+
+uint32_t VariationTree::addChild(uint32_t parent, const Move& move, const Game& position) {
+    uint32_t node = static_cast<uint32_t>(_nodes.size());
+    uint16_t ply = static_cast<uint16_t>(_nodes[parent].ply + 1);
+    uint32_t checkpoint = NoNode;
+    if(ply % CheckpointInterval == 0) {
+        checkpoint = static_cast<uint32_t>(_checkpoints.size());
+        _checkpoints.push_back(position);
+    }
+    _nodes.push_back(Node{
+        position.getHash(), parent, NoNode, NoNode, NoNode, checkpoint, ply,
+        static_cast<uint8_t>(move.origin.first * 8 + move.origin.second),
+        static_cast<uint8_t>(move.destination.first * 8 + move.destination.second),
+        static_cast<uint8_t>(move.type), static_cast<uint8_t>(position.getGameState()), {}
+    });
+    uint32_t* link = &_nodes[parent].firstChild;
+    while(*link != NoNode) {
+        link = &_nodes[*link].nextSibling;
+    }
+    *link = node;
+    return node;
+}
+
+Game VariationTree::getPosition(uint32_t node) const {
+    uint32_t path[CheckpointInterval];
+    short length = 0;
+    uint32_t current = node;
+    while(_nodes[current].checkpoint == NoNode) {
+        path[length++] = current;
+        current = _nodes[current].parent;
+    }
+    Game game(_checkpoints[_nodes[current].checkpoint]);
+    while(length > 0) {
+        applyMove(path[--length], game);
+    }
+    return game;
+}
+
+const Game& VariationTree::getRootPosition() const {
+    return _checkpoints.front();
+}
+
+void VariationTree::applyMove(uint32_t node, Game& game) const {
+    Move move = getMove(node);
+    game.move(move.origin, move.destination, move.type);
+    game.setGameState(getGameState(node));
+}
+
+Move VariationTree::getMove(uint32_t node) const {
+    const Node& n = _nodes[node];
+    return Move(
+        std::make_pair(static_cast<short>(n.origin / 8), static_cast<short>(n.origin % 8)),
+        std::make_pair(static_cast<short>(n.destination / 8), static_cast<short>(n.destination % 8)),
+        static_cast<MoveType>(n.type)
+    );
+}
+
+bool VariationTree::hasNotation(uint32_t node) const {
+    return _nodes[node].notation[0] != '\0';
+}
+
+const char* VariationTree::getNotation(uint32_t node) const {
+    return _nodes[node].notation;
+}
+
+void VariationTree::setNotation(uint32_t node, const std::string& notation) {
+    char* target = _nodes[node].notation;
+    size_t length = std::min(notation.size(), MaxNotationLength);
+    std::memcpy(target, notation.data(), length);
+    target[length] = '\0';
+}
+
+uint64_t VariationTree::getHash(uint32_t node) const {
+    return _nodes[node].hash;
+}
+
+GameState VariationTree::getGameState(uint32_t node) const {
+    return static_cast<GameState>(_nodes[node].state);
+}
+
+std::vector<uint32_t> VariationTree::getChildren(uint32_t node) const {
+    std::vector<uint32_t> children;
+    for(uint32_t child = _nodes[node].firstChild; child != NoNode; child = _nodes[child].nextSibling) {
+        children.push_back(child);
+    }
+    return children;
+}
+
+uint32_t VariationTree::getContinuation(uint32_t node) const {
+    return _nodes[node].continuation;
+}
+
+void VariationTree::setContinuation(uint32_t parent, uint32_t child) {
+    _nodes[parent].continuation = child;
+}
+
+size_t VariationTree::size() const {
+    return _nodes.size();
+}
+
+size_t VariationTree::getMemoryUsage() const {
+    return _nodes.capacity() * sizeof(Node) + _checkpoints.capacity() * sizeof(Game);
+}
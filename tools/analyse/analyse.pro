@@ -0,0 +1,20 @@
+# Batch analysis of FEN/EPD files, one JSON line per position.
+
+TEMPLATE = app
+TARGET = analyse
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    ../common/fen.cpp \
+    ../common/game_state.cpp \
+    ../common/json.cpp
+
+HEADERS += \
+    ../common/fen.hpp \
+    ../common/game_state.hpp \
+    ../common/json.hpp
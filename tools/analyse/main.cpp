@@ -0,0 +1,191 @@
+#include "../../include/chess/engine/engine.hpp"
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "../common/fen.hpp"
+#include "../common/game_state.hpp"
+#include "../common/json.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+struct Options {
+    SearchLimits limits;
+    size_t noThreads = 0;
+    bool stats = false;
+    std::string input;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--depth N] [--nodes N] [--threads N] [--stats] [file]\n"
+              << "Reads one FEN or EPD record per line from file (or stdin) and prints\n"
+              << "one JSON object per position, in input order.\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--depth" && i + 1 < argc) {
+            options.limits.depth = static_cast<short>(std::atoi(argv[++i]));
+        } else if(arg == "--nodes" && i + 1 < argc) {
+            options.limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--threads" && i + 1 < argc) {
+            options.noThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--stats") {
+            options.stats = true;
+        } else if(arg == "-h" || arg == "--help") {
+            return false;
+        } else if(!arg.empty() && arg[0] == '-' && arg != "-") {
+            return false;
+        } else {
+            options.input = arg;
+        }
+    }
+    if(options.limits.depth <= 0 && options.limits.nodes == 0) {
+        options.limits.depth = 3;
+    }
+    return true;
+}
+
+std::string analysePosition(size_t lineNo, const std::string& line, const SearchLimits& limits, uint64_t& nodes) {
+    thread_local std::unique_ptr<Engine> engine;
+    if(!engine) {
+        engine.reset(new Engine());
+    }
+    std::ostringstream json;
+    json << "{\"line\":" << lineNo;
+    try {
+        std::string fen = tools::extractCheckedFen(line);
+        json << ",\"fen\":" << tools::jsonString(fen);
+        engine->setBoard(fen);
+
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result = engine->analyse(limits);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        json << ",\"state\":" << tools::jsonString(tools::stateName(engine->getGameState()));
+        if(result.bestMove.type != MoveType::None) {
+            json << ",\"bestmove\":" << tools::jsonString(result.bestMove.getCoordinateNotation());
+        } else {
+            json << ",\"bestmove\":null";
+        }
+        if(result.isMate()) {
+            json << ",\"score\":{\"mate\":" << result.getMateDistance() << "}";
+        } else {
+            json << ",\"score\":{\"cp\":" << result.score << "}";
+        }
+        json << ",\"depth\":" << result.depth << ",\"pv\":[";
+        for(size_t i = 0; i < result.principalVariation.size(); i++) {
+            json << (i ? "," : "") << tools::jsonString(result.principalVariation[i].getCoordinateNotation());
+        }
+        json << "],\"nodes\":" << result.nodes
+             << ",\"time_ms\":" << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        nodes = result.nodes;
+    } catch(std::exception& e) {
+        json << ",\"error\":" << tools::jsonString(e.what());
+    }
+    json << "}";
+    return json.str();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if(!options.input.empty() && options.input != "-") {
+        file.open(options.input);
+        if(!file) {
+            std::cerr << "Error: Couldn't open " << options.input << "\n";
+            return 1;
+        }
+        input = &file;
+    }
+
+    ThreadPool pool(options.noThreads);
+    const size_t window = pool.size() * 16;
+
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    std::map<size_t, std::string> finished;
+    std::atomic<uint64_t> totalNodes(0);
+    size_t submitted = 0;
+    size_t printed = 0;
+    size_t lineNo = 0;
+    bool endOfInput = false;
+
+    auto start = std::chrono::steady_clock::now();
+    while(true) {
+        std::string line;
+        while(!endOfInput && submitted - printed < window) {
+            if(!std::getline(*input, line)) {
+                endOfInput = true;
+                break;
+            }
+            lineNo++;
+            if(tools::isBlank(line)) {
+                continue;
+            }
+            size_t index = submitted++;
+            pool.submit([&, index, lineNo, line]() {
+                uint64_t nodes = 0;
+                std::string json = analysePosition(lineNo, line, options.limits, nodes);
+                totalNodes += nodes;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished[index] = std::move(json);
+                }
+                finishedCondition.notify_one();
+            });
+        }
+        if(printed == submitted) {
+            break;
+        }
+
+        std::vector<std::string> ready;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finishedCondition.wait(lock, [&]{ return finished.count(printed) > 0; });
+            for(auto it = finished.find(printed); it != finished.end() && it->first == printed; it = finished.erase(it)) {
+                ready.push_back(std::move(it->second));
+                printed++;
+            }
+        }
+        for(const auto& json : ready) {
+            std::cout << json << '\n';
+        }
+        std::cout.flush();
+    }
+    pool.wait();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "{\"positions\":" << printed
+              << ",\"threads\":" << pool.size()
+              << ",\"nodes\":" << totalNodes.load()
+              << ",\"seconds\":" << seconds
+              << ",\"positions_per_second\":" << (seconds > 0 ? printed / seconds : 0)
+              << ",\"nodes_per_second\":" << (seconds > 0 ? totalNodes.load() / seconds : 0)
+              << "}\n";
+    if(options.stats) {
+        Engine::stats().print(std::cerr);
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+# Replays binary game archives, reports their size and speed, converts to PGN.
+
+TEMPLATE = app
+TARGET = archive
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    ../common/fen.cpp \
+    ../common/json.cpp
+
+HEADERS += \
+    ../common/fen.hpp \
+    ../common/json.hpp
@@ -0,0 +1,160 @@
+#include "../../include/chess/engine/engine.hpp"
+#include "../../include/chess/engine/game_archive.hpp"
+#include "../common/fen.hpp"
+#include "../common/json.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+struct Options {
+    std::string pgn;
+    std::vector<std::string> inputs;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--pgn FILE] archive...\n"
+              << "Replays every game of the given archives and prints one JSON object per\n"
+              << "archive with its size and replay speed. With --pgn the games are also\n"
+              << "written to FILE as PGN.\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--pgn" && i + 1 < argc) {
+            options.pgn = argv[++i];
+        } else if(!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return !options.inputs.empty();
+}
+
+std::string resultName(GameState result) {
+    switch(result) {
+    case GameState::WhiteWin:
+        return "1-0";
+    case GameState::BlackWin:
+        return "0-1";
+    case GameState::Draw:
+        return "1/2-1/2";
+    default:
+        return "*";
+    }
+}
+
+void writePgn(std::ostream& os, const ArchivedGame& archived) {
+    Game start = archived.getStartingPosition();
+    Engine engine;
+    std::string result = resultName(archived.result);
+    os << "[Event \"?\"]\n"
+       << "[Site \"?\"]\n"
+       << "[Result \"" << result << "\"]\n";
+    if(archived.customStart) {
+        std::string fen = tools::toFen(start) + " " + std::to_string(start.getNoHalfMoves()) + " " + std::to_string(start.getNoMoves());
+        engine.setBoard(fen);
+        os << "[SetUp \"1\"]\n"
+           << "[FEN \"" << fen << "\"]\n";
+    }
+    os << "\n";
+    for(const Move& move : archived.getMoves()) {
+        engine.selectPiece(move.origin);
+        engine.move(move.destination);
+    }
+
+    std::string line;
+    auto append = [&](const std::string& token) {
+        if(!line.empty() && line.size() + token.size() + 1 > 79) {
+            os << line << "\n";
+            line.clear();
+        }
+        line += line.empty() ? token : " " + token;
+    };
+    short moveNumber = engine.getStartingMoveIndex();
+    bool first = true;
+    for(const auto& move : engine.getMoveHistory()) {
+        if(move.getTurn() == PieceColor::White) {
+            append(std::to_string(moveNumber) + ".");
+        } else if(first) {
+            append(std::to_string(moveNumber) + "...");
+        }
+        append(move.getAlgebraicNotation());
+        if(move.getTurn() == PieceColor::Black) {
+            moveNumber++;
+        }
+        first = false;
+    }
+    append(result);
+    os << line << "\n\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream pgn;
+    if(!options.pgn.empty()) {
+        pgn.open(options.pgn);
+        if(!pgn) {
+            std::cerr << "Error: Couldn't open " << options.pgn << "\n";
+            return 1;
+        }
+    }
+
+    bool failed = false;
+    for(const std::string& input : options.inputs) {
+        std::ifstream file(input, std::ios::binary);
+        if(!file) {
+            std::cerr << "Error: Couldn't open " << input << "\n";
+            failed = true;
+            continue;
+        }
+        size_t noGames = 0;
+        uint64_t noPlies = 0;
+        double seconds = 0.0;
+        try {
+            GameArchiveReader reader(file);
+            ArchivedGame game;
+            while(reader.read(game)) {
+                auto start = std::chrono::steady_clock::now();
+                game.replay([&](const Game&, const Move&) {
+                    noPlies++;
+                });
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                noGames++;
+                if(pgn.is_open()) {
+                    writePgn(pgn, game);
+                }
+            }
+        } catch(std::invalid_argument& e) {
+            std::cerr << input << ": game " << noGames + 1 << ": " << e.what() << "\n";
+            failed = true;
+            continue;
+        }
+        file.clear();
+        std::streamoff bytes = file.seekg(0, std::ios::end).tellg();
+        std::cout << "{\"file\":" << tools::jsonString(input)
+                  << ",\"games\":" << noGames
+                  << ",\"plies\":" << noPlies
+                  << ",\"bytes\":" << bytes
+                  << ",\"bytes_per_ply\":" << (noPlies ? static_cast<double>(bytes) / noPlies : 0)
+                  << ",\"seconds\":" << seconds
+                  << ",\"plies_per_second\":" << (seconds > 0 ? noPlies / seconds : 0)
+                  << "}" << std::endl;
+    }
+    return failed ? 2 : 0;
+}
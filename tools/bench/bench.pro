@@ -0,0 +1,18 @@
+# Micro-benchmarks for the engine hot paths, results written as JSON.
+
+TEMPLATE = app
+TARGET = bench
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    benchmark.cpp \
+    ../common/json.cpp
+
+HEADERS += \
+    benchmark.hpp \
+    ../common/json.hpp
@@ -0,0 +1,106 @@
+#include "benchmark.hpp"
+#include "../common/json.hpp"
+#include <algorithm>
+#include <ctime>
+#include <thread>
+
+using namespace bench;
+
+State::State(uint64_t iterations)
+    : _iterations(iterations), _remaining(iterations), _running(false), _start(), _elapsed(0) {}
+
+bool State::keepRunning() {
+    if(!_running && _remaining == _iterations) {
+        resumeTiming();
+    }
+    if(_remaining == 0) {
+        pauseTiming();
+        return false;
+    }
+    _remaining--;
+    return true;
+}
+
+void State::pauseTiming() {
+    if(_running) {
+        _elapsed += std::chrono::steady_clock::now() - _start;
+        _running = false;
+    }
+}
+
+void State::resumeTiming() {
+    if(!_running) {
+        _start = std::chrono::steady_clock::now();
+        _running = true;
+    }
+}
+
+uint64_t State::getIterations() const {
+    return _iterations;
+}
+
+std::chrono::nanoseconds State::getElapsed() const {
+    return _elapsed;
+}
+
+Registry& Registry::instance() {
+    static Registry registry;
+    return registry;
+}
+
+void Registry::add(const std::string& name, std::function<void(State&)> benchmark) {
+    _benchmarks.emplace_back(name, benchmark);
+}
+
+std::vector<Result> Registry::run(const std::string& filter, std::chrono::milliseconds minTime, size_t repetitions) {
+    std::vector<Result> results;
+    for(auto& benchmark : _benchmarks) {
+        if(benchmark.first.find(filter) == std::string::npos) {
+            continue;
+        }
+        uint64_t iterations = 1;
+        std::chrono::nanoseconds elapsed(0);
+        while(true) {
+            State state(iterations);
+            benchmark.second(state);
+            elapsed = state.getElapsed();
+            if(elapsed >= minTime || iterations >= (1ull << 40)) {
+                break;
+            }
+            double scale = elapsed.count() > 0 ? 1.4 * minTime.count() * 1e6 / elapsed.count() : 100.0;
+            iterations = static_cast<uint64_t>(iterations * std::min(std::max(scale, 2.0), 100.0));
+        }
+
+        std::vector<double> samples;
+        samples.push_back(static_cast<double>(elapsed.count()) / iterations);
+        for(size_t i = 1; i < repetitions; i++) {
+            State state(iterations);
+            benchmark.second(state);
+            samples.push_back(static_cast<double>(state.getElapsed().count()) / iterations);
+        }
+        std::sort(samples.begin(), samples.end());
+        results.push_back(Result{benchmark.first, iterations, samples[samples.size() / 2]});
+    }
+    return results;
+}
+
+void bench::writeJson(std::ostream& os, const std::vector<Result>& results) {
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    os << "{\n"
+       << "  \"context\": {\n"
+       << "    \"date\": " << tools::jsonString(date) << ",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n"
+       << "  },\n"
+       << "  \"benchmarks\": [";
+    for(size_t i = 0; i < results.size(); i++) {
+        os << (i ? "," : "") << "\n    {"
+           << "\"name\": " << tools::jsonString(results[i].name)
+           << ", \"iterations\": " << results[i].iterations
+           << ", \"real_time\": " << results[i].nanosecondsPerIteration
+           << ", \"time_unit\": \"ns\"}";
+    }
+    os << "\n  ]\n}\n";
+}
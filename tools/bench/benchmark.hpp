@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+class State {
+public:
+    explicit State(uint64_t iterations);
+
+    bool keepRunning();
+    void pauseTiming();
+    void resumeTiming();
+
+    uint64_t getIterations() const;
+    std::chrono::nanoseconds getElapsed() const;
+
+private:
+    uint64_t _iterations;
+    uint64_t _remaining;
+    bool _running;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::nanoseconds _elapsed;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double nanosecondsPerIteration;
+};
+
+class Registry {
+public:
+    static Registry& instance();
+
+    void add(const std::string& name, std::function<void(State&)> benchmark);
+    std::vector<Result> run(const std::string& filter, std::chrono::milliseconds minTime, size_t repetitions);
+
+private:
+    std::vector<std::pair<std::string, std::function<void(State&)>>> _benchmarks;
+};
+
+void writeJson(std::ostream& os, const std::vector<Result>& results);
+
+template<typename T>
+void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+}
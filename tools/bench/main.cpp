@@ -0,0 +1,360 @@
+#include "../../include/chess/engine/arena.hpp"
+#include "../../include/chess/engine/engine.hpp"
+#include "../../include/chess/engine/game_archive.hpp"
+#include "../../include/chess/engine/game_rules.hpp"
+#include "../../include/chess/engine/packed_position.hpp"
+#include "../../include/chess/engine/pressure_factory.hpp"
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace chess;
+
+namespace {
+
+const char* startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -";
+const char* italianFen = "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4";
+
+class BenchGameRules : public GameRules {
+public:
+    using GameRules::GameRules;
+    using GameRules::setPossibleMoves;
+    using GameRules::removeInvalidMoves;
+};
+
+class BenchEngine : public Engine {
+public:
+    using Engine::setGameState;
+    using Engine::getNotation;
+};
+
+void registerBoardBenchmarks(bench::Registry& registry) {
+    registry.add("Board/copy", [](bench::State& state) {
+        Game game(italianFen);
+        const Board& board = game.getBoard();
+        while(state.keepRunning()) {
+            Board copy(board);
+            bench::doNotOptimize(copy);
+        }
+    });
+    registry.add("Board/lookupPair", [](bench::State& state) {
+        Game game(italianFen);
+        const Board& board = game.getBoard();
+        while(state.keepRunning()) {
+            for(short x = 0; x < 8; x++) {
+                for(short y = 0; y < 8; y++) {
+                    bench::doNotOptimize(board[std::make_pair(x, y)].piece);
+                }
+            }
+        }
+    });
+    registry.add("Board/lookupXY", [](bench::State& state) {
+        Game game(italianFen);
+        const Board& board = game.getBoard();
+        while(state.keepRunning()) {
+            for(short x = 0; x < 8; x++) {
+                for(short y = 0; y < 8; y++) {
+                    bench::doNotOptimize(board[x][y].piece);
+                }
+            }
+        }
+    });
+}
+
+void registerPressureFactoryBenchmarks(bench::Registry& registry) {
+    const std::pair<const char*, const char*> pieces[] = {
+        {"Pawn", "e4"}, {"Knight", "f3"}, {"Bishop", "c4"},
+        {"Rook", "h1"}, {"Queen", "d1"}, {"King", "e1"}
+    };
+    for(const auto& piece : pieces) {
+        auto position = Square::convertPosition(piece.second);
+        registry.add(std::string("PressureFactory/") + piece.first, [position](bench::State& state) {
+            Game game(italianFen);
+            const Board& board = game.getBoard();
+            while(state.keepRunning()) {
+                Arena::Scope scope(Arena::local());
+                PressureFactory pressureFactory(board, position, &Arena::local());
+                bench::doNotOptimize(pressureFactory);
+            }
+        });
+    }
+}
+
+void registerGameRulesBenchmarks(bench::Registry& registry) {
+    registry.add("GameRules/selectSquare", [](bench::State& state) {
+        Game game(italianFen);
+        GameRules gameRules(game);
+        auto knight = Square::convertPosition("f3");
+        while(state.keepRunning()) {
+            bench::doNotOptimize(gameRules.selectSquare(knight));
+        }
+    });
+    registry.add("GameRules/removeInvalidMoves", [](bench::State& state) {
+        Game game(italianFen);
+        BenchGameRules gameRules(game);
+        gameRules.selectSquare(Square::convertPosition("f3"));
+        while(state.keepRunning()) {
+            state.pauseTiming();
+            gameRules.setPossibleMoves();
+            state.resumeTiming();
+            gameRules.removeInvalidMoves();
+        }
+    });
+    registry.add("GameRules/isCheck", [](bench::State& state) {
+        Game game(italianFen);
+        GameRules gameRules(game);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(gameRules.isCheck(PieceColor::White));
+        }
+    });
+}
+
+void registerRulesBenchmarks(bench::Registry& registry) {
+    registry.add("rules/legalMoves", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            Arena::Scope scope(Arena::local());
+            bench::doNotOptimize(rules::legalMoves(game, &Arena::local()));
+        }
+    });
+    registry.add("rules/isCheck", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(rules::isCheck(game, PieceColor::White));
+        }
+    });
+    registry.add("rules/gameState", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(rules::gameState(game));
+        }
+    });
+    registry.add("rules/see", [](bench::State& state) {
+        Game game(italianFen);
+        Move move(Square::convertPosition("f3"), Square::convertPosition("e5"), MoveType::Normal);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(rules::see(game, move));
+        }
+    });
+}
+
+void registerEngineBenchmarks(bench::Registry& registry) {
+    registry.add("Engine/move", [](bench::State& state) {
+        Engine engine;
+        auto origin = Square::convertPosition("f3");
+        auto destination = Square::convertPosition("e5");
+        while(state.keepRunning()) {
+            state.pauseTiming();
+            engine.setBoard(italianFen);
+            engine.selectPiece(origin);
+            state.resumeTiming();
+            bench::doNotOptimize(engine.move(destination));
+        }
+    });
+    registry.add("Engine/selectPiece", [](bench::State& state) {
+        Engine engine;
+        engine.setBoard(italianFen);
+        auto knight = Square::convertPosition("f3");
+        while(state.keepRunning()) {
+            engine.selectPiece(knight);
+            bench::doNotOptimize(engine.getPossibleMoves());
+        }
+    });
+    registry.add("Engine/navigate", [](bench::State& state) {
+        Engine engine;
+        engine.setBoard(italianFen);
+        engine.selectPiece(Square::convertPosition("f3"));
+        engine.move(Square::convertPosition("e5"));
+        while(state.keepRunning()) {
+            engine.previousPosition();
+            engine.nextPosition();
+        }
+    });
+    registry.add("Engine/getNotation", [](bench::State& state) {
+        BenchEngine engine;
+        engine.setBoard(italianFen);
+        Move move(Square::convertPosition("f3"), Square::convertPosition("e5"), MoveType::Normal);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(engine.getNotation(engine.getGame(), move));
+        }
+    });
+    registry.add("Engine/setGameState", [](bench::State& state) {
+        BenchEngine engine;
+        engine.setBoard(italianFen);
+        while(state.keepRunning()) {
+            engine.setGameState();
+        }
+    });
+}
+
+void registerGameBenchmarks(bench::Registry& registry) {
+    registry.add("Game/parseStartingFen", [](bench::State& state) {
+        while(state.keepRunning()) {
+            Game game(startingFen);
+            bench::doNotOptimize(game);
+        }
+    });
+    registry.add("Game/parseItalianFen", [](bench::State& state) {
+        while(state.keepRunning()) {
+            Game game(italianFen);
+            bench::doNotOptimize(game);
+        }
+    });
+    registry.add("Game/getHash", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(game.getHash());
+        }
+    });
+    registry.add("Game/copy", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            Game copy(game);
+            bench::doNotOptimize(copy);
+        }
+    });
+}
+
+void registerPackedPositionBenchmarks(bench::Registry& registry) {
+    registry.add("PackedPosition/pack", [](bench::State& state) {
+        Game game(italianFen);
+        while(state.keepRunning()) {
+            PackedPosition position(game);
+            bench::doNotOptimize(position);
+        }
+    });
+    registry.add("PackedPosition/unpack", [](bench::State& state) {
+        PackedPosition position{Game(italianFen)};
+        while(state.keepRunning()) {
+            Game game = position.unpack();
+            bench::doNotOptimize(game);
+        }
+    });
+    registry.add("PackedPosition/compare", [](bench::State& state) {
+        PackedPosition position{Game(italianFen)};
+        PackedPosition other(position);
+        while(state.keepRunning()) {
+            bench::doNotOptimize(position == other);
+        }
+    });
+    registry.add("PackedPosition/getHash", [](bench::State& state) {
+        PackedPosition position{Game(italianFen)};
+        while(state.keepRunning()) {
+            bench::doNotOptimize(position.getHash());
+        }
+    });
+}
+
+// A 60 ply game that picks moves spread over the legal move list.
+std::vector<Move> archiveMoves() {
+    Game game;
+    std::vector<Move> moves;
+    for(size_t ply = 0; ply < 60; ply++) {
+        auto legalMoves = rules::legalMoves(game);
+        if(legalMoves.empty()) {
+            break;
+        }
+        Move move = legalMoves[ply * 7 % legalMoves.size()];
+        moves.push_back(move);
+        game.move(move.origin, move.destination, move.type);
+    }
+    return moves;
+}
+
+void registerGameArchiveBenchmarks(bench::Registry& registry) {
+    registry.add("GameArchive/write", [](bench::State& state) {
+        std::vector<Move> moves = archiveMoves();
+        Game start;
+        std::ostringstream os;
+        GameArchiveWriter writer(os);
+        while(state.keepRunning()) {
+            writer.write(start, moves, GameState::Draw);
+            os.seekp(4);
+        }
+    });
+    registry.add("GameArchive/replay", [](bench::State& state) {
+        std::ostringstream os;
+        GameArchiveWriter writer(os);
+        writer.write(Game(), archiveMoves(), GameState::Draw);
+        std::istringstream is(os.str());
+        GameArchiveReader reader(is);
+        ArchivedGame game;
+        reader.read(game);
+        while(state.keepRunning()) {
+            game.replay([](const Game& position, const Move&) {
+                bench::doNotOptimize(position);
+            });
+        }
+    });
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--filter SUBSTRING] [--min-time MS] [--repetitions N] [--out FILE] [--stats]\n"
+              << "Runs the engine micro-benchmarks and writes the results as JSON\n"
+              << "(to stdout unless --out is given).\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string out;
+    std::chrono::milliseconds minTime(200);
+    size_t repetitions = 3;
+    bool stats = false;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if(arg == "--min-time" && hasValue) {
+            minTime = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else if(arg == "--repetitions" && hasValue) {
+            repetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if(arg == "--out" && hasValue) {
+            out = argv[++i];
+        } else if(arg == "--stats") {
+            stats = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    bench::Registry& registry = bench::Registry::instance();
+    registerBoardBenchmarks(registry);
+    registerPressureFactoryBenchmarks(registry);
+    registerGameRulesBenchmarks(registry);
+    registerRulesBenchmarks(registry);
+    registerEngineBenchmarks(registry);
+    registerGameBenchmarks(registry);
+    registerPackedPositionBenchmarks(registry);
+    registerGameArchiveBenchmarks(registry);
+
+    auto results = registry.run(filter, minTime, repetitions);
+    for(const auto& result : results) {
+        std::cerr << std::left << std::setw(32) << result.name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << result.nanosecondsPerIteration << " ns"
+                  << std::setw(12) << result.iterations << "\n";
+    }
+    if(stats) {
+        Engine::stats().print(std::cerr);
+    }
+
+    if(out.empty()) {
+        bench::writeJson(std::cout, results);
+    } else {
+        std::ofstream file(out);
+        if(!file) {
+            std::cerr << "Error: Couldn't open " << out << "\n";
+            return 1;
+        }
+        bench::writeJson(file, results);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "fen.hpp"
+#include "../../include/chess/engine/game.hpp"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool isNumber(const std::string& s) {
+    if(s.empty()) {
+        return false;
+    }
+    for(char c : s) {
+        if(!isdigit(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool tools::isBlank(const std::string& s) {
+    for(char c : s) {
+        if(!isspace(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string tools::extractFen(const std::string& line) {
+    std::istringstream stream(line);
+    std::vector<std::string> fields;
+    std::string field;
+    while(fields.size() < 6 && stream >> field) {
+        fields.push_back(field);
+    }
+    if(fields.size() < 4) {
+        throw std::invalid_argument("Error: Not enough fields in fen");
+    }
+    std::string fen = fields[0] + ' ' + fields[1] + ' ' + fields[2] + ' ' + fields[3];
+    if(fields.size() == 6 && isNumber(fields[4]) && isNumber(fields[5])) {
+        fen += ' ' + fields[4] + ' ' + fields[5];
+    }
+    return fen;
+}
+
+std::string tools::toFen(const chess::Game& game) {
+    const chess::Board& board = game.getBoard();
+    std::string fen;
+    for(short y = 7; y >= 0; y--) {
+        short empty = 0;
+        for(short x = 0; x < 8; x++) {
+            chess::Piece piece = board[x][y].piece;
+            if(piece.type == chess::PieceType::None) {
+                empty++;
+                continue;
+            }
+            if(empty > 0) {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            fen += static_cast<char>(piece);
+        }
+        if(empty > 0) {
+            fen += static_cast<char>('0' + empty);
+        }
+        if(y > 0) {
+            fen += '/';
+        }
+    }
+    fen += game.getTurn() == chess::PieceColor::White ? " w " : " b ";
+    std::string castling;
+    if(game.canWhiteCastleH()) {
+        castling += 'K';
+    }
+    if(game.canWhiteCastleA()) {
+        castling += 'Q';
+    }
+    if(game.canBlackCastleH()) {
+        castling += 'k';
+    }
+    if(game.canBlackCastleA()) {
+        castling += 'q';
+    }
+    fen += castling.empty() ? "-" : castling;
+    fen += ' ';
+    const chess::Square* enPassant = game.getEnPassantSquare();
+    fen += enPassant ? chess::Square::convertPosition(enPassant->getPosition()) : "-";
+    return fen;
+}
+
+std::string tools::extractCheckedFen(const std::string& line) {
+    std::string fen = extractFen(line.substr(0, line.find(';')));
+    chess::Game game(fen);
+    if(!game.getWhiteKingSquare() || !game.getBlackKingSquare()) {
+        throw std::invalid_argument("Error: Position is missing a king");
+    }
+    return fen;
+}
+
+std::vector<tools::FenRecord> tools::loadFenRecords(const std::string& filename) {
+    std::vector<FenRecord> records;
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if(filename != "-") {
+        file.open(filename);
+        if(!file) {
+            throw std::runtime_error("Error: Couldn't open " + filename);
+        }
+        input = &file;
+    }
+    std::string line;
+    size_t lineNo = 0;
+    while(std::getline(*input, line)) {
+        lineNo++;
+        if(isBlank(line)) {
+            continue;
+        }
+        try {
+            records.push_back(FenRecord{lineNo, extractCheckedFen(line), line});
+        } catch(std::invalid_argument& e) {
+            std::cerr << filename << ":" << lineNo << ": " << e.what() << ", skipped\n";
+        }
+    }
+    return records;
+}
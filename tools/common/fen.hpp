@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace chess {
+class Game;
+}
+
+namespace tools {
+
+bool isBlank(const std::string& s);
+std::string extractFen(const std::string& line);
+// The four position fields of game; move counters are left out.
+std::string toFen(const chess::Game& game);
+
+struct FenRecord {
+    size_t lineNo;
+    std::string fen;
+    std::string line;
+};
+
+// The FEN of a FEN or EPD record, ignoring EPD operations after the first
+// ';'. Throws invalid_argument unless it loads as a Game with both kings.
+std::string extractCheckedFen(const std::string& line);
+// Every valid record of filename, or of stdin for "-". Blank lines are
+// skipped, and so are invalid records, with a note on stderr.
+std::vector<FenRecord> loadFenRecords(const std::string& filename);
+
+}
@@ -0,0 +1,15 @@
+#include "game_state.hpp"
+#include "../../include/chess/engine/game_state.hpp"
+
+std::string tools::stateName(chess::GameState state) {
+    switch(state) {
+    case chess::GameState::WhiteWin:
+        return "white_win";
+    case chess::GameState::BlackWin:
+        return "black_win";
+    case chess::GameState::Draw:
+        return "draw";
+    default:
+        return "playing";
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace chess {
+enum class GameState;
+}
+
+namespace tools {
+
+// playing, white_win, black_win or draw, as the tools print game states.
+std::string stateName(chess::GameState state);
+
+}
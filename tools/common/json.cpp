@@ -0,0 +1,36 @@
+#include "json.hpp"
+#include <cstdio>
+
+std::string tools::jsonString(const std::string& s) {
+    std::string escaped = "\"";
+    for(char c : s) {
+        switch(c) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if(static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                escaped += buffer;
+            } else {
+                escaped += c;
+            }
+            break;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
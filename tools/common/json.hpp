@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string>
+
+namespace tools {
+
+std::string jsonString(const std::string& s);
+
+}
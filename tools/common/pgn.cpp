@@ -0,0 +1,215 @@
+#include "pgn.hpp"
+#include "../../include/chess/engine/arena.hpp"
+#include "../../include/chess/engine/rules.hpp"
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+bool parseResult(const std::string& token, chess::GameState& result) {
+    if(token == "1-0") {
+        result = chess::GameState::WhiteWin;
+    } else if(token == "0-1") {
+        result = chess::GameState::BlackWin;
+    } else if(token == "1/2-1/2") {
+        result = chess::GameState::Draw;
+    } else if(token == "*") {
+        result = chess::GameState::Playing;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void parseTag(const std::string& line, tools::PgnGame& game) {
+    size_t nameBegin = line.find('[') + 1;
+    size_t nameEnd = line.find(' ', nameBegin);
+    size_t valueBegin = line.find('"');
+    size_t valueEnd = line.rfind('"');
+    if(nameEnd == std::string::npos || valueBegin == std::string::npos || valueEnd <= valueBegin) {
+        return;
+    }
+    std::string name = line.substr(nameBegin, nameEnd - nameBegin);
+    std::string value = line.substr(valueBegin + 1, valueEnd - valueBegin - 1);
+    if(name == "FEN") {
+        game.fen = value;
+    } else if(name == "Result") {
+        parseResult(value, game.result);
+    }
+}
+
+}
+
+tools::PgnGame::PgnGame()
+    : fen(), result(chess::GameState::Playing), moves() {}
+
+tools::PgnReader::PgnReader(std::istream& is)
+    : _is(is), _lineNo(0), _pendingLine() {}
+
+bool tools::PgnReader::read(PgnGame& game) {
+    game = PgnGame();
+    bool inComment = false;
+    short variationDepth = 0;
+    std::string line;
+    while(getLine(line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if(first == std::string::npos || line[first] == '%') {
+            continue;
+        }
+        if(!inComment && variationDepth == 0 && line[first] == '[') {
+            if(!game.moves.empty()) {
+                _pendingLine = line;
+                return true;
+            }
+            parseTag(line, game);
+            continue;
+        }
+        std::string token;
+        bool finished = false;
+        auto flush = [&]() {
+            if(token.empty()) {
+                return;
+            }
+            if(parseResult(token, game.result)) {
+                finished = true;
+            } else if(token[0] != '$') {
+                size_t move = token.find_first_not_of("0123456789.");
+                if(move != std::string::npos) {
+                    game.moves.push_back(token.substr(move));
+                }
+            }
+            token.clear();
+        };
+        for(size_t i = first; i < line.size() && !finished; i++) {
+            char c = line[i];
+            if(inComment) {
+                inComment = c != '}';
+            } else if(c == '{') {
+                flush();
+                inComment = true;
+            } else if(c == ';') {
+                break;
+            } else if(c == '(') {
+                flush();
+                variationDepth++;
+            } else if(c == ')') {
+                variationDepth--;
+            } else if(variationDepth > 0) {
+                continue;
+            } else if(isspace(static_cast<unsigned char>(c))) {
+                flush();
+            } else {
+                token += c;
+            }
+        }
+        flush();
+        if(finished) {
+            return true;
+        }
+    }
+    return !game.moves.empty();
+}
+
+size_t tools::PgnReader::getLineNo() const {
+    return _lineNo;
+}
+
+bool tools::PgnReader::getLine(std::string& line) {
+    if(!_pendingLine.empty()) {
+        line.swap(_pendingLine);
+        _pendingLine.clear();
+        return true;
+    }
+    if(!std::getline(_is, line)) {
+        return false;
+    }
+    _lineNo++;
+    return true;
+}
+
+chess::Move tools::parseSan(const chess::Game& game, const std::string& san) {
+    using namespace chess;
+    std::string text = san.substr(0, san.find_last_not_of("+#!?") + 1);
+    Arena::Scope scope(Arena::local());
+    auto legalMoves = rules::legalMoves(game, &Arena::local());
+    if(text == "O-O" || text == "0-0" || text == "O-O-O" || text == "0-0-0") {
+        short x = text.size() == 3 ? 6 : 2;
+        for(const Move& move : legalMoves) {
+            if(move.type == MoveType::Castle && move.destination.first == x) {
+                return move;
+            }
+        }
+        throw std::invalid_argument("Error: Illegal move " + san);
+    }
+
+    PieceType type = PieceType::Pawn;
+    size_t begin = 0;
+    if(!text.empty() && std::string("KQRBN").find(text[0]) != std::string::npos) {
+        type = Piece(text[0]).type;
+        begin = 1;
+    }
+    size_t promotion = text.find('=');
+    if(promotion == std::string::npos && type == PieceType::Pawn && !text.empty() && std::string("QRBN").find(text.back()) != std::string::npos) {
+        promotion = text.size() - 1;
+    }
+    if(promotion != std::string::npos) {
+        if(text.substr(promotion) != "=Q" && text.substr(promotion) != "Q") {
+            throw std::invalid_argument("Error: Only promotion to a queen is supported in " + san);
+        }
+        text.erase(promotion);
+    }
+    std::string squares;
+    for(size_t i = begin; i < text.size(); i++) {
+        if(text[i] != 'x' && text[i] != '-' && text[i] != ':') {
+            squares += text[i];
+        }
+    }
+    if(squares.size() < 2 || squares.size() > 4) {
+        throw std::invalid_argument("Error: Invalid move " + san);
+    }
+    std::string destination = squares.substr(squares.size() - 2);
+    if(destination[0] < 'a' || destination[0] > 'h' || destination[1] < '1' || destination[1] > '8') {
+        throw std::invalid_argument("Error: Invalid move " + san);
+    }
+    std::pair<short, short> target = Square::convertPosition(destination);
+    short file = -1;
+    short rank = -1;
+    for(char c : squares.substr(0, squares.size() - 2)) {
+        if(c >= 'a' && c <= 'h') {
+            file = c - 'a';
+        } else if(c >= '1' && c <= '8') {
+            rank = c - '1';
+        } else {
+            throw std::invalid_argument("Error: Invalid move " + san);
+        }
+    }
+
+    const Board& board = game.getBoard();
+    Move found;
+    for(const Move& move : legalMoves) {
+        if(move.destination != target || board[move.origin].piece.type != type
+                || (file >= 0 && move.origin.first != file) || (rank >= 0 && move.origin.second != rank)) {
+            continue;
+        }
+        if(found.type != MoveType::None) {
+            throw std::invalid_argument("Error: Ambiguous move " + san);
+        }
+        found = move;
+    }
+    if(found.type == MoveType::None) {
+        throw std::invalid_argument("Error: Illegal move " + san);
+    }
+    return found;
+}
+
+std::vector<chess::Move> tools::parseSanMoves(const chess::Game& start, const std::vector<std::string>& moves) {
+    std::vector<chess::Move> result;
+    result.reserve(moves.size());
+    chess::Game game(start);
+    for(const std::string& san : moves) {
+        chess::Move move = parseSan(game, san);
+        result.push_back(move);
+        game.move(move.origin, move.destination, move.type);
+    }
+    return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+#include "../../include/chess/engine/game.hpp"
+#include "../../include/chess/engine/move.hpp"
+
+namespace tools {
+
+// A game as it stands in the file, with its moves still in SAN.
+struct PgnGame {
+    PgnGame();
+
+    // Empty when the game starts from the usual position.
+    std::string fen;
+    chess::GameState result;
+    std::vector<std::string> moves;
+};
+
+// Reads one game at a time, dropping comments, variations and NAGs.
+class PgnReader {
+public:
+    explicit PgnReader(std::istream& is);
+
+    // Returns false once the file is exhausted.
+    bool read(PgnGame& game);
+    size_t getLineNo() const;
+
+private:
+    bool getLine(std::string& line);
+
+    std::istream& _is;
+    size_t _lineNo;
+    // A tag line that ended a game without a result token.
+    std::string _pendingLine;
+};
+
+// The legal move a SAN token names. Throws invalid_argument when it names
+// none or several of them, and for promotions to anything but a queen.
+chess::Move parseSan(const chess::Game& game, const std::string& san);
+std::vector<chess::Move> parseSanMoves(const chess::Game& start, const std::vector<std::string>& moves);
+
+}
@@ -0,0 +1,54 @@
+#include "backend.hpp"
+#include "../../include/chess/engine/move_generator.hpp"
+#include <stdexcept>
+
+using namespace tools;
+using namespace chess;
+
+GameState RulesBackend::getState(const Game& game, bool canMove, bool check) {
+    if(canMove) {
+        return GameState::Playing;
+    }
+    if(!check) {
+        return GameState::Draw;
+    }
+    return game.getTurn() == PieceColor::White ? GameState::BlackWin : GameState::WhiteWin;
+}
+
+std::string LegacyBackend::getName() const {
+    return "legacy";
+}
+
+void LegacyBackend::examine(const Game& game, RulesReport& report) {
+    if(!_gameRules) {
+        _gameRules.reset(new GameRules(game));
+    } else {
+        _gameRules->selectGame(game);
+    }
+    auto moves = _gameRules->getLegalMoves();
+    report.moves.assign(moves.begin(), moves.end());
+    report.check = _gameRules->isCheck(game.getTurn());
+    report.state = getState(game, !report.moves.empty(), report.check);
+}
+
+std::string TableBackend::getName() const {
+    return "table";
+}
+
+void TableBackend::examine(const Game& game, RulesReport& report) {
+    MoveGenerator generator(game);
+    auto moves = generator.getLegalMoves();
+    report.moves.assign(moves.begin(), moves.end());
+    report.check = generator.isCheck();
+    report.state = getState(game, !report.moves.empty(), report.check);
+}
+
+std::unique_ptr<RulesBackend> tools::createBackend(const std::string& name) {
+    if(name == "legacy") {
+        return std::unique_ptr<RulesBackend>(new LegacyBackend());
+    }
+    if(name == "table") {
+        return std::unique_ptr<RulesBackend>(new TableBackend());
+    }
+    throw std::invalid_argument("Error: Unknown rules backend " + name);
+}
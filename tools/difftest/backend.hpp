@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../../include/chess/engine/game.hpp"
+#include "../../include/chess/engine/game_rules.hpp"
+#include "../../include/chess/engine/move.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tools {
+
+// What a rules implementation says about one position. The state only
+// covers what the rules decide: mate, stalemate or still playing.
+struct RulesReport {
+    std::vector<chess::Move> moves;
+    bool check = false;
+    chess::GameState state = chess::GameState::Playing;
+};
+
+class RulesBackend {
+public:
+    virtual ~RulesBackend() = default;
+
+    virtual std::string getName() const = 0;
+    virtual void examine(const chess::Game& game, RulesReport& report) = 0;
+
+protected:
+    static chess::GameState getState(const chess::Game& game, bool canMove, bool check);
+};
+
+// GameRules and PressureFactory, the implementation the engine grew up with.
+class LegacyBackend : public RulesBackend {
+public:
+    std::string getName() const override;
+    void examine(const chess::Game& game, RulesReport& report) override;
+
+private:
+    std::unique_ptr<chess::GameRules> _gameRules;
+};
+
+// MoveGenerator's occupancy masks and attack tables.
+class TableBackend : public RulesBackend {
+public:
+    std::string getName() const override;
+    void examine(const chess::Game& game, RulesReport& report) override;
+};
+
+std::unique_ptr<RulesBackend> createBackend(const std::string& name);
+
+}
@@ -0,0 +1,23 @@
+# Compares the legacy rules with an optimised backend on random playouts and
+# FEN/EPD suites, one JSON line per disagreement.
+
+TEMPLATE = app
+TARGET = difftest
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    backend.cpp \
+    ../common/fen.cpp \
+    ../common/game_state.cpp \
+    ../common/json.cpp
+
+HEADERS += \
+    backend.hpp \
+    ../common/fen.hpp \
+    ../common/game_state.hpp \
+    ../common/json.hpp
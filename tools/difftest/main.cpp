@@ -0,0 +1,348 @@
+#include "../../include/chess/engine/game_rules.hpp"
+#include "../common/fen.hpp"
+#include "../common/game_state.hpp"
+#include "../common/json.hpp"
+#include "backend.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+const char* startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -";
+
+struct Options {
+    std::string reference = "legacy";
+    std::string candidate = "table";
+    size_t games = 100;
+    size_t plies = 200;
+    uint64_t seed = 1;
+    size_t maxFailures = 10;
+    std::string input;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] [file]\n"
+              << "  --reference NAME     rules backend trusted to be right (default legacy)\n"
+              << "  --candidate NAME     rules backend under test (default table)\n"
+              << "  --games N            random playouts to walk (default 100)\n"
+              << "  --plies N            longest playout (default 200)\n"
+              << "  --seed N             playout random seed (default 1)\n"
+              << "  --max-failures N     stop after N disagreements (default 10)\n"
+              << "Compares the legal moves, check and mate or stalemate of both backends on\n"
+              << "every position of file (FEN or EPD, one per line) and of random playouts\n"
+              << "started from them, or from the starting position without a file. Every\n"
+              << "disagreement is printed as one JSON object with the smallest position that\n"
+              << "still shows it. Backends: legacy, table.\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--reference" && hasValue) {
+            options.reference = argv[++i];
+        } else if(arg == "--candidate" && hasValue) {
+            options.candidate = argv[++i];
+        } else if(arg == "--games" && hasValue) {
+            options.games = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--plies" && hasValue) {
+            options.plies = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--max-failures" && hasValue) {
+            options.maxFailures = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "-h" || arg == "--help") {
+            return false;
+        } else if(!arg.empty() && arg[0] == '-' && arg != "-") {
+            return false;
+        } else {
+            options.input = arg;
+        }
+    }
+    return true;
+}
+
+bool moveLess(const Move& a, const Move& b) {
+    return std::tie(a.origin, a.destination, a.type) < std::tie(b.origin, b.destination, b.type);
+}
+
+std::string jsonMoves(const std::vector<Move>& moves) {
+    std::string json = "[";
+    for(size_t i = 0; i < moves.size(); i++) {
+        json += (i ? "," : "") + tools::jsonString(moves[i].getCoordinateNotation());
+    }
+    return json + "]";
+}
+
+// The position fields of a FEN with the board as one character per square,
+// x * 8 + y like Board, so single pieces can be taken off while shrinking.
+struct EditablePosition {
+    std::array<char, 64> squares;
+    std::string turn;
+    std::string castling;
+    std::string enPassant;
+
+    explicit EditablePosition(const Game& game);
+    std::string toFen() const;
+};
+
+EditablePosition::EditablePosition(const Game& game)
+    : squares() {
+    for(short square = 0; square < 64; square++) {
+        Piece piece = game.getBoard().getSquare(square).piece;
+        squares[square] = piece.type == PieceType::None ? '\0' : static_cast<char>(piece);
+    }
+    std::istringstream fields(tools::toFen(game));
+    std::string placement;
+    fields >> placement >> turn >> castling >> enPassant;
+}
+
+std::string EditablePosition::toFen() const {
+    std::string fen;
+    for(short y = 7; y >= 0; y--) {
+        short empty = 0;
+        for(short x = 0; x < 8; x++) {
+            char piece = squares[x * 8 + y];
+            if(!piece) {
+                empty++;
+                continue;
+            }
+            if(empty > 0) {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            fen += piece;
+        }
+        if(empty > 0) {
+            fen += static_cast<char>('0' + empty);
+        }
+        if(y > 0) {
+            fen += '/';
+        }
+    }
+    return fen + ' ' + turn + ' ' + castling + ' ' + enPassant;
+}
+
+// Runs both backends on every position it is given, keeps the time each
+// one took and reports disagreements.
+class Comparison {
+public:
+    Comparison(tools::RulesBackend& reference, tools::RulesBackend& candidate);
+
+    bool compare(const Game& game, const std::string& source);
+    const tools::RulesReport& getReference() const;
+    void printReport(std::ostream& os) const;
+
+    size_t getFailures() const;
+
+protected:
+    bool agrees(const Game& game);
+    bool isValid(const EditablePosition& position);
+    std::string shrink(const Game& game);
+
+private:
+    tools::RulesBackend& _reference;
+    tools::RulesBackend& _candidate;
+    tools::RulesReport _referenceReport;
+    tools::RulesReport _candidateReport;
+    std::chrono::steady_clock::duration _referenceTime;
+    std::chrono::steady_clock::duration _candidateTime;
+    size_t _positions;
+    size_t _failures;
+};
+
+Comparison::Comparison(tools::RulesBackend& reference, tools::RulesBackend& candidate)
+    : _reference(reference), _candidate(candidate), _referenceReport(), _candidateReport(),
+      _referenceTime(0), _candidateTime(0), _positions(0), _failures(0) {}
+
+bool Comparison::compare(const Game& game, const std::string& source) {
+    auto start = std::chrono::steady_clock::now();
+    _reference.examine(game, _referenceReport);
+    auto middle = std::chrono::steady_clock::now();
+    _candidate.examine(game, _candidateReport);
+    auto end = std::chrono::steady_clock::now();
+    _referenceTime += middle - start;
+    _candidateTime += end - middle;
+    _positions++;
+
+    std::sort(_referenceReport.moves.begin(), _referenceReport.moves.end(), moveLess);
+    std::sort(_candidateReport.moves.begin(), _candidateReport.moves.end(), moveLess);
+    if(_referenceReport.moves == _candidateReport.moves
+            && _referenceReport.check == _candidateReport.check
+            && _referenceReport.state == _candidateReport.state) {
+        return true;
+    }
+    _failures++;
+
+    std::vector<Move> missing;
+    std::vector<Move> extra;
+    std::set_difference(_referenceReport.moves.begin(), _referenceReport.moves.end(),
+                        _candidateReport.moves.begin(), _candidateReport.moves.end(),
+                        std::back_inserter(missing), moveLess);
+    std::set_difference(_candidateReport.moves.begin(), _candidateReport.moves.end(),
+                        _referenceReport.moves.begin(), _referenceReport.moves.end(),
+                        std::back_inserter(extra), moveLess);
+    std::cout << "{\"source\":" << tools::jsonString(source)
+              << ",\"fen\":" << tools::jsonString(tools::toFen(game))
+              << ",\"missing\":" << jsonMoves(missing)
+              << ",\"extra\":" << jsonMoves(extra)
+              << ",\"check\":{" << tools::jsonString(_reference.getName()) << ":" << (_referenceReport.check ? "true" : "false")
+              << "," << tools::jsonString(_candidate.getName()) << ":" << (_candidateReport.check ? "true" : "false") << "}"
+              << ",\"state\":{" << tools::jsonString(_reference.getName()) << ":" << tools::jsonString(tools::stateName(_referenceReport.state))
+              << "," << tools::jsonString(_candidate.getName()) << ":" << tools::jsonString(tools::stateName(_candidateReport.state)) << "}";
+    std::string minimal = shrink(game);
+    std::cout << ",\"minimal_fen\":" << tools::jsonString(minimal) << "}" << std::endl;
+
+    // Shrinking overwrote the reports; playouts continue from the reference.
+    _reference.examine(game, _referenceReport);
+    std::sort(_referenceReport.moves.begin(), _referenceReport.moves.end(), moveLess);
+    return false;
+}
+
+const tools::RulesReport& Comparison::getReference() const {
+    return _referenceReport;
+}
+
+void Comparison::printReport(std::ostream& os) const {
+    double referenceSeconds = std::chrono::duration<double>(_referenceTime).count();
+    double candidateSeconds = std::chrono::duration<double>(_candidateTime).count();
+    os << "{\"positions\":" << _positions
+       << ",\"failures\":" << _failures
+       << ",\"" << _reference.getName() << "_seconds\":" << referenceSeconds
+       << ",\"" << _candidate.getName() << "_seconds\":" << candidateSeconds
+       << ",\"" << _reference.getName() << "_positions_per_second\":" << (referenceSeconds > 0 ? _positions / referenceSeconds : 0)
+       << ",\"" << _candidate.getName() << "_positions_per_second\":" << (candidateSeconds > 0 ? _positions / candidateSeconds : 0)
+       << ",\"speedup\":" << (candidateSeconds > 0 ? referenceSeconds / candidateSeconds : 0)
+       << "}\n";
+}
+
+size_t Comparison::getFailures() const {
+    return _failures;
+}
+
+bool Comparison::agrees(const Game& game) {
+    _reference.examine(game, _referenceReport);
+    _candidate.examine(game, _candidateReport);
+    std::sort(_referenceReport.moves.begin(), _referenceReport.moves.end(), moveLess);
+    std::sort(_candidateReport.moves.begin(), _candidateReport.moves.end(), moveLess);
+    return _referenceReport.moves == _candidateReport.moves
+        && _referenceReport.check == _candidateReport.check
+        && _referenceReport.state == _candidateReport.state;
+}
+
+// Positions where the side that just moved is still in check can't come
+// up in a game, so shrinking never steps into one.
+bool Comparison::isValid(const EditablePosition& position) {
+    EditablePosition flipped(position);
+    flipped.turn = position.turn == "w" ? "b" : "w";
+    flipped.enPassant = "-";
+    Game game(flipped.toFen());
+    if(!game.getWhiteKingSquare() || !game.getBlackKingSquare()) {
+        return false;
+    }
+    GameRules gameRules(game);
+    return !gameRules.isCheck(game.getTurn());
+}
+
+// Greedily drops single castling rights, the en passant square and pieces
+// for as long as the backends keep disagreeing.
+std::string Comparison::shrink(const Game& game) {
+    EditablePosition position(game);
+    bool shrunk = true;
+    while(shrunk) {
+        shrunk = false;
+        std::vector<EditablePosition> candidates;
+        if(position.castling != "-") {
+            for(size_t i = 0; i < position.castling.size(); i++) {
+                candidates.push_back(position);
+                std::string& castling = candidates.back().castling;
+                castling.erase(i, 1);
+                if(castling.empty()) {
+                    castling = "-";
+                }
+            }
+        }
+        if(position.enPassant != "-") {
+            candidates.push_back(position);
+            candidates.back().enPassant = "-";
+        }
+        for(short square = 0; square < 64; square++) {
+            char piece = position.squares[square];
+            if(piece && piece != 'K' && piece != 'k') {
+                candidates.push_back(position);
+                candidates.back().squares[square] = '\0';
+            }
+        }
+        for(const auto& candidate : candidates) {
+            try {
+                if(isValid(candidate) && !agrees(Game(candidate.toFen()))) {
+                    position = candidate;
+                    shrunk = true;
+                    break;
+                }
+            } catch(std::invalid_argument&) {
+            }
+        }
+    }
+    return position.toFen();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::unique_ptr<tools::RulesBackend> reference;
+    std::unique_ptr<tools::RulesBackend> candidate;
+    std::vector<tools::FenRecord> suite;
+    try {
+        if(!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        reference = tools::createBackend(options.reference);
+        candidate = tools::createBackend(options.candidate);
+        if(!options.input.empty()) {
+            suite = tools::loadFenRecords(options.input);
+        }
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    Comparison comparison(*reference, *candidate);
+    for(const auto& position : suite) {
+        if(comparison.getFailures() >= options.maxFailures) {
+            break;
+        }
+        comparison.compare(Game(position.fen), "line " + std::to_string(position.lineNo));
+    }
+
+    std::mt19937_64 random(options.seed);
+    for(size_t i = 0; i < options.games && comparison.getFailures() < options.maxFailures; i++) {
+        std::string start = suite.empty() ? startingFen : suite[random() % suite.size()].fen;
+        Game game(start);
+        for(size_t ply = 0; ply <= options.plies && comparison.getFailures() < options.maxFailures; ply++) {
+            comparison.compare(game, "game " + std::to_string(i + 1) + " ply " + std::to_string(ply));
+            const auto& moves = comparison.getReference().moves;
+            if(moves.empty() || ply == options.plies) {
+                break;
+            }
+            const Move& move = moves[random() % moves.size()];
+            game.move(move.origin, move.destination, move.type);
+        }
+    }
+
+    comparison.printReport(std::cerr);
+    return comparison.getFailures() > 0 ? 2 : 0;
+}
@@ -0,0 +1,21 @@
+# Builds opening explorer indexes from PGN files and game archives, and
+# queries them, one JSON line per position.
+
+TEMPLATE = app
+TARGET = explorer
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    ../common/fen.cpp \
+    ../common/json.cpp \
+    ../common/pgn.cpp
+
+HEADERS += \
+    ../common/fen.hpp \
+    ../common/json.hpp \
+    ../common/pgn.hpp
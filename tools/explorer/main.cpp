@@ -0,0 +1,283 @@
+#include "../../include/chess/engine/game_archive.hpp"
+#include "../../include/chess/engine/opening_index.hpp"
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "../common/fen.hpp"
+#include "../common/json.hpp"
+#include "../common/pgn.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+const size_t BatchSize = 256;
+
+struct Options {
+    std::string command;
+    size_t noThreads = 0;
+    short maxPlies = 30;
+    uint32_t minGames = 1;
+    std::string index;
+    std::vector<std::string> inputs;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " build [options] --out FILE input...\n"
+              << "       " << program << " query --index FILE [file]\n"
+              << "  --threads N          worker threads for build (default: all cores)\n"
+              << "  --max-plies N        plies of every game to count (default 30)\n"
+              << "  --min-games N        leave out moves played in fewer games (default 1)\n"
+              << "build replays PGN files and game archives into a sorted opening index.\n"
+              << "query reads one FEN or EPD record per line from file (or stdin) and prints\n"
+              << "the moves played from every position as one JSON object per line.\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    if(argc < 2) {
+        return false;
+    }
+    options.command = argv[1];
+    for(int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--threads" && hasValue) {
+            options.noThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--max-plies" && hasValue) {
+            options.maxPlies = static_cast<short>(std::atoi(argv[++i]));
+        } else if(arg == "--min-games" && hasValue) {
+            options.minGames = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if((arg == "--out" || arg == "--index") && hasValue) {
+            options.index = argv[++i];
+        } else if(!arg.empty() && arg[0] == '-' && arg != "-") {
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    if(options.command == "build") {
+        return !options.index.empty() && !options.inputs.empty() && options.maxPlies > 0;
+    }
+    return options.command == "query" && !options.index.empty() && options.inputs.size() <= 1;
+}
+
+// Hands batches of games to the pool, keeping a few batches per thread in
+// flight so reading never runs far ahead of replaying.
+class BatchQueue {
+public:
+    explicit BatchQueue(ThreadPool& pool)
+        : _pool(pool), _limit(pool.size() * 4), _inFlight(0) {}
+
+    void submit(std::function<void()> task) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _available.wait(lock, [this]{ return _inFlight < _limit; });
+            _inFlight++;
+        }
+        _pool.submit([this, task]() {
+            task();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _inFlight--;
+            }
+            _available.notify_one();
+        });
+    }
+
+private:
+    ThreadPool& _pool;
+    size_t _limit;
+    size_t _inFlight;
+    std::mutex _mutex;
+    std::condition_variable _available;
+};
+
+bool isArchive(std::istream& is) {
+    char magic[4] = {};
+    is.read(magic, sizeof(magic));
+    bool archive = is.gcount() == sizeof(magic) && std::memcmp(magic, "CGA1", sizeof(magic)) == 0;
+    is.clear();
+    is.seekg(0);
+    return archive;
+}
+
+void readArchive(std::istream& is, OpeningIndexBuilder& builder, BatchQueue& queue, std::atomic<size_t>& skipped) {
+    GameArchiveReader reader(is);
+    auto batch = std::make_shared<std::vector<ArchivedGame>>();
+    auto submit = [&]() {
+        queue.submit([&builder, &skipped, batch]() {
+            for(const ArchivedGame& game : *batch) {
+                try {
+                    builder.add(game);
+                } catch(std::invalid_argument&) {
+                    skipped++;
+                }
+            }
+        });
+    };
+    batch->emplace_back();
+    while(reader.read(batch->back())) {
+        if(batch->size() == BatchSize) {
+            submit();
+            batch = std::make_shared<std::vector<ArchivedGame>>();
+        }
+        batch->emplace_back();
+    }
+    batch->pop_back();
+    submit();
+}
+
+void readPgn(std::istream& is, short maxPlies, OpeningIndexBuilder& builder, BatchQueue& queue, std::atomic<size_t>& skipped) {
+    tools::PgnReader reader(is);
+    auto batch = std::make_shared<std::vector<tools::PgnGame>>();
+    auto submit = [&]() {
+        queue.submit([&builder, &skipped, batch]() {
+            for(const tools::PgnGame& game : *batch) {
+                try {
+                    Game start = game.fen.empty() ? Game() : Game(tools::extractFen(game.fen));
+                    builder.add(start, tools::parseSanMoves(start, game.moves), game.result);
+                } catch(std::invalid_argument&) {
+                    skipped++;
+                }
+            }
+        });
+    };
+    batch->emplace_back();
+    while(reader.read(batch->back())) {
+        // Later moves are never counted, so they need not be parsed.
+        std::vector<std::string>& moves = batch->back().moves;
+        if(moves.size() > static_cast<size_t>(maxPlies)) {
+            moves.resize(maxPlies);
+        }
+        if(batch->size() == BatchSize) {
+            submit();
+            batch = std::make_shared<std::vector<tools::PgnGame>>();
+        }
+        batch->emplace_back();
+    }
+    batch->pop_back();
+    submit();
+}
+
+int build(const Options& options) {
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.noThreads);
+    BatchQueue queue(pool);
+    OpeningIndexBuilder builder(options.maxPlies);
+    std::atomic<size_t> skipped(0);
+    for(const std::string& input : options.inputs) {
+        std::ifstream file(input, std::ios::binary);
+        if(!file) {
+            std::cerr << "Error: Couldn't open " << input << "\n";
+            return 1;
+        }
+        try {
+            if(isArchive(file)) {
+                readArchive(file, builder, queue, skipped);
+            } else {
+                readPgn(file, options.maxPlies, builder, queue, skipped);
+            }
+        } catch(std::invalid_argument& e) {
+            std::cerr << input << ": " << e.what() << "\n";
+            pool.wait();
+            return 1;
+        }
+    }
+    pool.wait();
+    double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t noGames = builder.getNoGames();
+    size_t noPlies = builder.getNoPlies();
+
+    size_t noEntries;
+    try {
+        noEntries = builder.write(options.index, pool, options.minGames);
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "{\"games\":" << noGames
+              << ",\"skipped\":" << skipped
+              << ",\"plies\":" << noPlies
+              << ",\"entries\":" << noEntries
+              << ",\"bytes\":" << OpeningIndex::HeaderSize + noEntries * sizeof(OpeningIndex::Entry)
+              << ",\"threads\":" << pool.size()
+              << ",\"replay_seconds\":" << replaySeconds
+              << ",\"seconds\":" << seconds
+              << ",\"games_per_second\":" << (seconds > 0 ? noGames / seconds : 0)
+              << "}" << std::endl;
+    return 0;
+}
+
+int query(const Options& options) {
+    OpeningIndex index;
+    try {
+        index.open(options.index);
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::ifstream file;
+    if(!options.inputs.empty() && options.inputs[0] != "-") {
+        file.open(options.inputs[0]);
+        if(!file) {
+            std::cerr << "Error: Couldn't open " << options.inputs[0] << "\n";
+            return 1;
+        }
+    }
+    std::istream& input = file.is_open() ? file : std::cin;
+    std::string line;
+    size_t lineNo = 0;
+    while(std::getline(input, line)) {
+        lineNo++;
+        if(tools::isBlank(line)) {
+            continue;
+        }
+        std::cout << "{\"line\":" << lineNo;
+        try {
+            Game game(tools::extractFen(line));
+            auto start = std::chrono::steady_clock::now();
+            std::vector<OpeningMove> moves = index.find(game);
+            double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            std::cout << ",\"fen\":" << tools::jsonString(tools::toFen(game))
+                      << ",\"microseconds\":" << microseconds
+                      << ",\"moves\":[";
+            for(size_t i = 0; i < moves.size(); i++) {
+                const OpeningMove& move = moves[i];
+                std::cout << (i ? "," : "") << "{\"move\":" << tools::jsonString(move.move.getCoordinateNotation())
+                          << ",\"games\":" << move.getNoGames()
+                          << ",\"white_wins\":" << move.whiteWins
+                          << ",\"draws\":" << move.draws
+                          << ",\"black_wins\":" << move.blackWins
+                          << "}";
+            }
+            std::cout << "]";
+        } catch(std::invalid_argument& e) {
+            std::cout << ",\"error\":" << tools::jsonString(e.what());
+        }
+        std::cout << "}" << std::endl;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    return options.command == "build" ? build(options) : query(options);
+}
@@ -0,0 +1,320 @@
+#include "../../include/chess/engine/arena.hpp"
+#include "../../include/chess/engine/game_rules.hpp"
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "../common/fen.hpp"
+#include "../common/json.hpp"
+#include "perft_table.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+const char* startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -";
+
+struct Options {
+    short depth = 0;
+    std::vector<size_t> threadCounts;
+    size_t hash = 64;
+    bool divide = false;
+    std::string input;
+};
+
+struct Position {
+    size_t lineNo;
+    std::string fen;
+    std::map<short, uint64_t> expected;
+};
+
+struct Totals {
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] [file]\n"
+              << "  --depth N            perft depth (default: deepest D field of the record, else 4)\n"
+              << "  --threads N[,N...]   thread counts to measure (default: 1, 2, 4, ... all cores)\n"
+              << "  --hash MB            shared subtree table size, 0 disables it (default 64)\n"
+              << "  --divide             print the leaf count below every root move\n"
+              << "Reads one FEN or EPD record per line from file (default: starting position)\n"
+              << "and prints one JSON object per position and thread count. EPD fields like\n"
+              << "\";D4 197281\" are checked, and any mismatch makes the exit status non-zero.\n";
+}
+
+std::vector<size_t> parseThreadCounts(const std::string& list) {
+    std::vector<size_t> counts;
+    std::istringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if(count <= 0) {
+            throw std::invalid_argument("Error: Invalid thread count " + item);
+        }
+        counts.push_back(static_cast<size_t>(count));
+    }
+    return counts;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--depth" && hasValue) {
+            options.depth = static_cast<short>(std::atoi(argv[++i]));
+        } else if(arg == "--threads" && hasValue) {
+            options.threadCounts = parseThreadCounts(argv[++i]);
+        } else if(arg == "--hash" && hasValue) {
+            options.hash = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--divide") {
+            options.divide = true;
+        } else if(arg == "-h" || arg == "--help") {
+            return false;
+        } else if(!arg.empty() && arg[0] == '-' && arg != "-") {
+            return false;
+        } else {
+            options.input = arg;
+        }
+    }
+    if(options.threadCounts.empty()) {
+        size_t cores = ThreadPool::defaultSize();
+        for(size_t count = 1; count < cores; count *= 2) {
+            options.threadCounts.push_back(count);
+        }
+        options.threadCounts.push_back(cores);
+    }
+    return options.depth >= 0;
+}
+
+// Reads the ";D<depth> <nodes>" fields perft suites append to each record.
+std::map<short, uint64_t> parseExpected(const std::string& line) {
+    std::map<short, uint64_t> expected;
+    size_t semicolon = line.find(';');
+    while(semicolon != std::string::npos) {
+        size_t next = line.find(';', semicolon + 1);
+        std::istringstream field(line.substr(semicolon + 1, next == std::string::npos ? next : next - semicolon - 1));
+        std::string name;
+        uint64_t nodes;
+        if(field >> name >> nodes && name.size() > 1 && name[0] == 'D') {
+            expected[static_cast<short>(std::atoi(name.c_str() + 1))] = nodes;
+        }
+        semicolon = next;
+    }
+    return expected;
+}
+
+std::vector<Position> loadPositions(const std::string& filename) {
+    std::vector<Position> positions;
+    if(filename.empty()) {
+        positions.push_back(Position{0, startingFen, {}});
+        return positions;
+    }
+    for(const auto& record : tools::loadFenRecords(filename)) {
+        positions.push_back(Position{record.lineNo, record.fen, parseExpected(record.line)});
+    }
+    return positions;
+}
+
+// Depth first leaf counter for one thread. Subtrees of depth 2 and more go
+// through the shared table; depth 1 is just the number of legal moves.
+class Perft {
+public:
+    explicit Perft(tools::PerftTable& table);
+
+    uint64_t count(const Game& game, short depth);
+    uint64_t takeHashHits();
+
+protected:
+    uint64_t count(const Game& game, short depth, short ply);
+    GameRules& getGameRules(const Game& game, short ply);
+
+private:
+    tools::PerftTable& _table;
+    std::vector<std::unique_ptr<GameRules>> _gameRules;
+    uint64_t _hashHits;
+};
+
+Perft::Perft(tools::PerftTable& table)
+    : _table(table), _gameRules(), _hashHits(0) {}
+
+uint64_t Perft::count(const Game& game, short depth) {
+    return count(game, depth, 0);
+}
+
+uint64_t Perft::takeHashHits() {
+    uint64_t hashHits = _hashHits;
+    _hashHits = 0;
+    return hashHits;
+}
+
+uint64_t Perft::count(const Game& game, short depth, short ply) {
+    if(depth == 0) {
+        return 1;
+    }
+    uint64_t hash = 0;
+    uint64_t nodes = 0;
+    if(depth >= 2 && _table.isEnabled()) {
+        hash = game.getHash();
+        if(_table.find(hash, depth, nodes)) {
+            _hashHits++;
+            return nodes;
+        }
+    }
+
+    Arena::Scope scope(Arena::local());
+    auto moves = getGameRules(game, ply).getLegalMoves(&Arena::local());
+    if(depth == 1) {
+        return moves.size();
+    }
+    for(const auto& move : moves) {
+        Game child(game);
+        child.move(move.origin, move.destination, move.type);
+        nodes += count(child, depth - 1, ply + 1);
+    }
+    if(_table.isEnabled()) {
+        _table.store(hash, depth, nodes);
+    }
+    return nodes;
+}
+
+GameRules& Perft::getGameRules(const Game& game, short ply) {
+    while(_gameRules.size() <= static_cast<size_t>(ply)) {
+        _gameRules.push_back(std::make_unique<GameRules>(game));
+    }
+    GameRules& gameRules = *_gameRules[ply];
+    gameRules.selectGame(game);
+    return gameRules;
+}
+
+struct RootMove {
+    Move move;
+    uint64_t nodes;
+};
+
+// Splits the root moves across the pool; the table is shared by all of them.
+uint64_t runPerft(const Game& game, short depth, ThreadPool& pool, tools::PerftTable& table,
+                  std::vector<RootMove>& rootMoves, uint64_t& hashHits) {
+    rootMoves.clear();
+    if(depth == 0) {
+        return 1;
+    }
+    GameRules gameRules(game);
+    for(const auto& move : gameRules.getLegalMoves()) {
+        rootMoves.push_back(RootMove{move, 0});
+    }
+
+    std::atomic<uint64_t> totalHashHits(0);
+    for(auto& rootMove : rootMoves) {
+        pool.submit([&game, &table, &totalHashHits, &rootMove, depth]() {
+            thread_local std::unique_ptr<Perft> perft;
+            if(!perft) {
+                perft.reset(new Perft(table));
+            }
+            Game child(game);
+            child.move(rootMove.move.origin, rootMove.move.destination, rootMove.move.type);
+            rootMove.nodes = perft->count(child, depth - 1);
+            totalHashHits += perft->takeHashHits();
+        });
+    }
+    pool.wait();
+
+    uint64_t nodes = 0;
+    for(const auto& rootMove : rootMoves) {
+        nodes += rootMove.nodes;
+    }
+    hashHits = totalHashHits.load();
+    return nodes;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<Position> positions;
+    try {
+        if(!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        positions = loadPositions(options.input);
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    tools::PerftTable table(options.hash);
+    std::map<size_t, Totals> totals;
+    bool failed = false;
+
+    for(const auto& position : positions) {
+        short depth = options.depth;
+        if(depth == 0) {
+            depth = position.expected.empty() ? 4 : position.expected.rbegin()->first;
+        }
+        auto expected = position.expected.find(depth);
+        Game game(position.fen);
+
+        for(size_t threads : options.threadCounts) {
+            ThreadPool pool(threads);
+            std::vector<RootMove> rootMoves;
+            uint64_t hashHits = 0;
+            table.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = runPerft(game, depth, pool, table, rootMoves, hashHits);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            totals[threads].nodes += nodes;
+            totals[threads].seconds += seconds;
+
+            std::cout << "{\"line\":" << position.lineNo
+                      << ",\"fen\":" << tools::jsonString(position.fen)
+                      << ",\"depth\":" << depth
+                      << ",\"threads\":" << pool.size()
+                      << ",\"nodes\":" << nodes
+                      << ",\"hash_hits\":" << hashHits
+                      << ",\"seconds\":" << seconds
+                      << ",\"nodes_per_second\":" << (seconds > 0 ? nodes / seconds : 0);
+            if(expected != position.expected.end()) {
+                bool ok = nodes == expected->second;
+                failed = failed || !ok;
+                std::cout << ",\"expected\":" << expected->second
+                          << ",\"ok\":" << (ok ? "true" : "false");
+            }
+            if(options.divide && threads == options.threadCounts.front()) {
+                std::cout << ",\"divide\":{";
+                for(size_t i = 0; i < rootMoves.size(); i++) {
+                    std::cout << (i ? "," : "") << tools::jsonString(rootMoves[i].move.getCoordinateNotation())
+                              << ":" << rootMoves[i].nodes;
+                }
+                std::cout << "}";
+            }
+            std::cout << "}" << std::endl;
+        }
+    }
+
+    double baseline = 0.0;
+    for(const auto& entry : totals) {
+        const Totals& total = entry.second;
+        double nodesPerSecond = total.seconds > 0 ? total.nodes / total.seconds : 0;
+        if(baseline == 0.0) {
+            baseline = nodesPerSecond;
+        }
+        std::cerr << "{\"threads\":" << entry.first
+                  << ",\"nodes\":" << total.nodes
+                  << ",\"seconds\":" << total.seconds
+                  << ",\"nodes_per_second\":" << nodesPerSecond
+                  << ",\"speedup\":" << (baseline > 0 ? nodesPerSecond / baseline : 0)
+                  << "}\n";
+    }
+    return failed ? 2 : 0;
+}
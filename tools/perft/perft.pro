@@ -0,0 +1,20 @@
+# Multi-threaded perft for validating move generation, one JSON line per run.
+
+TEMPLATE = app
+TARGET = perft
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    perft_table.cpp \
+    ../common/fen.cpp \
+    ../common/json.cpp
+
+HEADERS += \
+    perft_table.hpp \
+    ../common/fen.hpp \
+    ../common/json.hpp
@@ -0,0 +1,62 @@
+#include "perft_table.hpp"
+
+using namespace tools;
+
+PerftTable::PerftTable(size_t megabytes)
+    : _entries(), _size(0) {
+    size_t capacity = megabytes * 1024 * 1024 / sizeof(Entry);
+    if(capacity == 0) {
+        return;
+    }
+    _size = 1;
+    while(_size * 2 <= capacity) {
+        _size *= 2;
+    }
+    _entries.reset(new Entry[_size]);
+    clear();
+}
+
+bool PerftTable::find(uint64_t hash, short depth, uint64_t& nodes) const {
+    if(_size == 0) {
+        return false;
+    }
+    uint64_t key = getKey(hash, depth);
+    const Entry& entry = _entries[key & (_size - 1)];
+    uint64_t stored = entry.nodes.load(std::memory_order_relaxed);
+    if((entry.check.load(std::memory_order_relaxed) ^ stored) != key) {
+        return false;
+    }
+    nodes = stored;
+    return true;
+}
+
+void PerftTable::store(uint64_t hash, short depth, uint64_t nodes) {
+    if(_size == 0) {
+        return;
+    }
+    uint64_t key = getKey(hash, depth);
+    Entry& entry = _entries[key & (_size - 1)];
+    entry.check.store(key ^ nodes, std::memory_order_relaxed);
+    entry.nodes.store(nodes, std::memory_order_relaxed);
+}
+
+void PerftTable::clear() {
+    for(size_t i = 0; i < _size; i++) {
+        _entries[i].check.store(0, std::memory_order_relaxed);
+        _entries[i].nodes.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool PerftTable::isEnabled() const {
+    return _size > 0;
+}
+
+size_t PerftTable::size() const {
+    return _size;
+}
+
+uint64_t PerftTable::getKey(uint64_t hash, short depth) {
+    // Spread the depth over the index bits as well as the check bits.
+    uint64_t key = hash ^ (static_cast<uint64_t>(depth) * 0x9e3779b97f4a7c15ULL);
+    return key == 0 ? 1 : key;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace tools {
+
+// Subtree leaf counts keyed by (Game::getHash, depth), shared by every
+// perft thread without locks. An entry stores its key xor its count, so a
+// slot torn by two threads writing at once reads back as a miss.
+class PerftTable {
+public:
+    explicit PerftTable(size_t megabytes);
+    PerftTable(const PerftTable& other) = delete;
+
+    PerftTable& operator=(const PerftTable& other) = delete;
+
+    bool find(uint64_t hash, short depth, uint64_t& nodes) const;
+    void store(uint64_t hash, short depth, uint64_t nodes);
+    void clear();
+
+    bool isEnabled() const;
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> nodes;
+    };
+
+    static uint64_t getKey(uint64_t hash, short depth);
+
+    std::unique_ptr<Entry[]> _entries;
+    size_t _size;
+};
+
+}
@@ -0,0 +1,470 @@
+#include "../../include/chess/engine/engine.hpp"
+#include "../../include/chess/engine/game_archive.hpp"
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "../common/fen.hpp"
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace chess;
+
+namespace {
+
+const char* startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -";
+
+struct Player {
+    std::string name;
+    SearchLimits limits;
+};
+
+struct Options {
+    Player players[2];
+    std::chrono::milliseconds base{0};
+    std::chrono::milliseconds increment{0};
+    size_t concurrency = 0;
+    size_t noThreads = 0;
+    size_t rounds = 1;
+    size_t maxPlies = 400;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+    bool stats = false;
+    std::string openings;
+    std::string pgn;
+    std::string archive;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --openings FILE      one FEN or EPD record per line (default: starting position)\n"
+              << "  --rounds N           play every opening N times with both colours (default 1)\n"
+              << "  --concurrency N      games played at the same time (default 4 per thread)\n"
+              << "  --threads N          worker threads (default: all cores)\n"
+              << "  --tc BASE+INC        time control in seconds, e.g. 10+0.1\n"
+              << "  --depth-a N, --depth-b N, --nodes-a N, --nodes-b N\n"
+              << "                       per engine search limits\n"
+              << "  --max-plies N        adjudicate a draw after N plies (default 400)\n"
+              << "  --sprt ELO0 ELO1     SPRT hypotheses (default 0 5)\n"
+              << "  --pgn FILE           write finished games to FILE\n"
+              << "  --archive FILE       write finished games to FILE as a binary game archive\n"
+              << "  --stats              print engine hot path statistics at the end\n";
+}
+
+std::chrono::milliseconds parseSeconds(const std::string& s) {
+    return std::chrono::milliseconds(static_cast<long long>(std::atof(s.c_str()) * 1000));
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.players[0].name = "EngineA";
+    options.players[1].name = "EngineB";
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--openings" && hasValue) {
+            options.openings = argv[++i];
+        } else if(arg == "--rounds" && hasValue) {
+            options.rounds = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--concurrency" && hasValue) {
+            options.concurrency = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--threads" && hasValue) {
+            options.noThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--tc" && hasValue) {
+            std::string tc = argv[++i];
+            size_t plus = tc.find('+');
+            options.base = parseSeconds(tc.substr(0, plus));
+            if(plus != std::string::npos) {
+                options.increment = parseSeconds(tc.substr(plus + 1));
+            }
+        } else if((arg == "--depth-a" || arg == "--depth-b") && hasValue) {
+            options.players[arg.back() == 'a' ? 0 : 1].limits.depth = static_cast<short>(std::atoi(argv[++i]));
+        } else if((arg == "--nodes-a" || arg == "--nodes-b") && hasValue) {
+            options.players[arg.back() == 'a' ? 0 : 1].limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if(arg == "--max-plies" && hasValue) {
+            options.maxPlies = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--sprt" && i + 2 < argc) {
+            options.elo0 = std::atof(argv[++i]);
+            options.elo1 = std::atof(argv[++i]);
+        } else if(arg == "--pgn" && hasValue) {
+            options.pgn = argv[++i];
+        } else if(arg == "--archive" && hasValue) {
+            options.archive = argv[++i];
+        } else if(arg == "--stats") {
+            options.stats = true;
+        } else {
+            return false;
+        }
+    }
+    for(auto& player : options.players) {
+        if(player.limits.depth <= 0 && player.limits.nodes == 0 && options.base.count() == 0) {
+            player.limits.depth = 2;
+        }
+    }
+    return options.rounds > 0;
+}
+
+std::vector<std::string> loadOpenings(const std::string& filename) {
+    std::vector<std::string> openings;
+    if(filename.empty()) {
+        openings.push_back(startingFen);
+        return openings;
+    }
+    for(const auto& record : tools::loadFenRecords(filename)) {
+        openings.push_back(record.fen);
+    }
+    return openings;
+}
+
+double scoreToElo(double score) {
+    return 400.0 * std::log10(score / (1.0 - score));
+}
+
+class Match {
+public:
+    Match(const Options& options, const std::vector<std::string>& openings, ThreadPool& pool, std::ostream* pgn, GameArchiveWriter* archive);
+
+    void run();
+    void printReport(std::ostream& os);
+
+protected:
+    struct SelfPlayGame {
+        SelfPlayGame(size_t round, const std::string& opening, size_t whitePlayer);
+
+        size_t round;
+        std::string opening;
+        size_t whitePlayer;
+        PieceColor turn;
+        size_t plies;
+        std::chrono::milliseconds clocks[2];
+        Engine engine;
+    };
+
+    bool startNextGame();
+    void playMove(std::shared_ptr<SelfPlayGame> game);
+    void finishGame(std::shared_ptr<SelfPlayGame> game, GameState state, const std::string& termination);
+    void writePgn(SelfPlayGame& game, const std::string& result, const std::string& termination);
+    double logLikelihoodRatio() const;
+    std::string sprtState() const;
+
+private:
+    const Options& _options;
+    const std::vector<std::string>& _openings;
+    ThreadPool& _pool;
+    std::ostream* _pgn;
+    GameArchiveWriter* _archive;
+    std::mutex _mutex;
+    std::condition_variable _done;
+    size_t _scheduled;
+    size_t _total;
+    size_t _running;
+    size_t _wins, _draws, _losses;
+    std::chrono::steady_clock::time_point _start;
+};
+
+Match::SelfPlayGame::SelfPlayGame(size_t round, const std::string& opening, size_t whitePlayer)
+    : round(round), opening(opening), whitePlayer(whitePlayer), turn(Game(opening).getTurn()),
+      plies(0), clocks(), engine() {
+    engine.setBoard(opening);
+}
+
+Match::Match(const Options& options, const std::vector<std::string>& openings, ThreadPool& pool, std::ostream* pgn, GameArchiveWriter* archive)
+    : _options(options), _openings(openings), _pool(pool), _pgn(pgn), _archive(archive),
+      _scheduled(0), _total(options.rounds * openings.size() * 2), _running(0),
+      _wins(0), _draws(0), _losses(0) {}
+
+void Match::run() {
+    _start = std::chrono::steady_clock::now();
+    size_t concurrency = _options.concurrency ? _options.concurrency : _pool.size() * 4;
+    for(size_t i = 0; i < concurrency; i++) {
+        if(!startNextGame()) {
+            break;
+        }
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]{ return _running == 0 && _scheduled == _total; });
+}
+
+bool Match::startNextGame() {
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_scheduled == _total) {
+            return false;
+        }
+        index = _scheduled++;
+        _running++;
+    }
+    size_t round = index / (_openings.size() * 2) + 1;
+    const std::string& opening = _openings[(index / 2) % _openings.size()];
+    auto game = std::make_shared<SelfPlayGame>(round, opening, index % 2);
+    for(auto& clock : game->clocks) {
+        clock = _options.base;
+    }
+    _pool.submit([this, game]() { playMove(game); });
+    return true;
+}
+
+void Match::playMove(std::shared_ptr<SelfPlayGame> game) {
+    Engine& engine = game->engine;
+    if(engine.getGameState() != GameState::Playing) {
+        finishGame(game, engine.getGameState(), "normal");
+        return;
+    }
+    if(game->plies >= _options.maxPlies) {
+        finishGame(game, GameState::Draw, "adjudication");
+        return;
+    }
+
+    size_t side = Piece::colorIndex(game->turn);
+    size_t player = side == 0 ? game->whitePlayer : 1 - game->whitePlayer;
+    SearchLimits limits = _options.players[player].limits;
+    bool timed = _options.base.count() > 0;
+    if(timed) {
+        auto budget = game->clocks[side] / 20 + _options.increment * 3 / 4;
+        if(budget >= game->clocks[side]) {
+            budget = game->clocks[side] / 2;
+        }
+        limits.time = std::max(budget, std::chrono::milliseconds(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = engine.analyse(limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    if(timed) {
+        game->clocks[side] -= elapsed;
+        if(game->clocks[side].count() < 0) {
+            finishGame(game, game->turn == PieceColor::White ? GameState::BlackWin : GameState::WhiteWin, "time forfeit");
+            return;
+        }
+        game->clocks[side] += _options.increment;
+    }
+
+    const Move& move = result.bestMove;
+    if(move.type == MoveType::None || !engine.selectPiece(move.origin) || !engine.move(move.destination)) {
+        finishGame(game, game->turn == PieceColor::White ? GameState::BlackWin : GameState::WhiteWin, "illegal move");
+        return;
+    }
+    game->plies++;
+    game->turn = game->turn == PieceColor::White ? PieceColor::Black : PieceColor::White;
+    _pool.submit([this, game]() { playMove(game); });
+}
+
+void Match::finishGame(std::shared_ptr<SelfPlayGame> game, GameState state, const std::string& termination) {
+    std::string result;
+    double whiteScore;
+    switch(state) {
+    case GameState::WhiteWin:
+        result = "1-0";
+        whiteScore = 1.0;
+        break;
+    case GameState::BlackWin:
+        result = "0-1";
+        whiteScore = 0.0;
+        break;
+    default:
+        result = "1/2-1/2";
+        whiteScore = 0.5;
+        break;
+    }
+    double scoreA = game->whitePlayer == 0 ? whiteScore : 1.0 - whiteScore;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(scoreA == 1.0) {
+            _wins++;
+        } else if(scoreA == 0.0) {
+            _losses++;
+        } else {
+            _draws++;
+        }
+        writePgn(*game, result, termination);
+        if(_archive) {
+            _archive->write(game->engine, state);
+        }
+        size_t played = _wins + _draws + _losses;
+        std::cerr << "Game " << played << "/" << _total << ": "
+                  << _options.players[game->whitePlayer].name << " vs "
+                  << _options.players[1 - game->whitePlayer].name << " " << result
+                  << " (" << termination << ", " << game->plies << " plies)"
+                  << "  W-D-L " << _wins << "-" << _draws << "-" << _losses
+                  << "  LLR " << std::fixed << std::setprecision(2) << logLikelihoodRatio()
+                  << std::defaultfloat << "\n";
+    }
+    game.reset();
+    startNextGame();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _running--;
+    _done.notify_all();
+}
+
+void Match::writePgn(SelfPlayGame& game, const std::string& result, const std::string& termination) {
+    if(!_pgn) {
+        return;
+    }
+    std::time_t now = std::time(nullptr);
+    char date[16];
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+
+    std::ostream& os = *_pgn;
+    os << "[Event \"Self-play\"]\n"
+       << "[Site \"?\"]\n"
+       << "[Date \"" << date << "\"]\n"
+       << "[Round \"" << game.round << "\"]\n"
+       << "[White \"" << _options.players[game.whitePlayer].name << "\"]\n"
+       << "[Black \"" << _options.players[1 - game.whitePlayer].name << "\"]\n"
+       << "[Result \"" << result << "\"]\n";
+    if(game.opening != startingFen) {
+        os << "[SetUp \"1\"]\n"
+           << "[FEN \"" << game.opening << "\"]\n";
+    }
+    if(_options.base.count() > 0) {
+        os << "[TimeControl \"" << _options.base.count() / 1000.0 << "+" << _options.increment.count() / 1000.0 << "\"]\n";
+    }
+    os << "[Termination \"" << termination << "\"]\n\n";
+
+    std::string line;
+    auto append = [&](const std::string& token) {
+        if(!line.empty() && line.size() + token.size() + 1 > 79) {
+            os << line << "\n";
+            line.clear();
+        }
+        line += line.empty() ? token : " " + token;
+    };
+    short moveNumber = game.engine.getStartingMoveIndex();
+    bool first = true;
+    for(const auto& move : game.engine.getMoveHistory()) {
+        if(move.getTurn() == PieceColor::White) {
+            append(std::to_string(moveNumber) + ".");
+        } else if(first) {
+            append(std::to_string(moveNumber) + "...");
+        }
+        append(move.getAlgebraicNotation());
+        if(move.getTurn() == PieceColor::Black) {
+            moveNumber++;
+        }
+        first = false;
+    }
+    append(result);
+    os << line << "\n\n";
+    os.flush();
+}
+
+double Match::logLikelihoodRatio() const {
+    double games = static_cast<double>(_wins + _draws + _losses);
+    if(games == 0) {
+        return 0.0;
+    }
+    double mean = (_wins + 0.5 * _draws) / games;
+    double variance = (_wins * std::pow(1.0 - mean, 2) + _draws * std::pow(0.5 - mean, 2) + _losses * std::pow(mean, 2)) / games;
+    if(variance <= 0.0) {
+        return 0.0;
+    }
+    double score0 = 1.0 / (1.0 + std::pow(10.0, -_options.elo0 / 400.0));
+    double score1 = 1.0 / (1.0 + std::pow(10.0, -_options.elo1 / 400.0));
+    return games * (score1 - score0) * (2.0 * mean - score0 - score1) / (2.0 * variance);
+}
+
+std::string Match::sprtState() const {
+    double llr = logLikelihoodRatio();
+    double lower = std::log(_options.beta / (1.0 - _options.alpha));
+    double upper = std::log((1.0 - _options.beta) / _options.alpha);
+    std::ostringstream state;
+    state << std::fixed << std::setprecision(2) << "LLR " << llr << " [" << lower << ", " << upper << "] ";
+    if(llr >= upper) {
+        state << "H1 accepted";
+    } else if(llr <= lower) {
+        state << "H0 accepted";
+    } else {
+        state << "inconclusive";
+    }
+    return state.str();
+}
+
+void Match::printReport(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t games = _wins + _draws + _losses;
+    double hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count() / 3600.0;
+    os << "Games: " << games << "  " << _options.players[0].name << " W-D-L: "
+       << _wins << "-" << _draws << "-" << _losses << "\n";
+    if(games > 0) {
+        double mean = (_wins + 0.5 * _draws) / games;
+        double variance = (_wins * std::pow(1.0 - mean, 2) + _draws * std::pow(0.5 - mean, 2) + _losses * std::pow(mean, 2)) / games;
+        double margin = 1.96 * std::sqrt(variance / games);
+        os << std::fixed << std::setprecision(1);
+        if(mean > 0.0 && mean < 1.0) {
+            double low = std::max(mean - margin, 1e-6);
+            double high = std::min(mean + margin, 1.0 - 1e-6);
+            os << "Elo difference: " << scoreToElo(mean)
+               << " +/- " << (scoreToElo(high) - scoreToElo(low)) / 2.0 << "\n";
+        } else {
+            os << "Elo difference: " << (mean > 0.0 ? "+inf" : "-inf") << "\n";
+        }
+        os << std::defaultfloat;
+    }
+    os << "SPRT (" << _options.elo0 << ", " << _options.elo1 << "): " << sprtState() << "\n";
+    os << "Games/hour: " << std::fixed << std::setprecision(1) << (hours > 0.0 ? games / hours : 0.0)
+       << std::defaultfloat << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> openings;
+    try {
+        openings = loadOpenings(options.openings);
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    if(openings.empty()) {
+        std::cerr << "Error: No valid openings\n";
+        return 1;
+    }
+
+    std::ofstream pgn;
+    if(!options.pgn.empty()) {
+        pgn.open(options.pgn, std::ios::app);
+        if(!pgn) {
+            std::cerr << "Error: Couldn't open " << options.pgn << "\n";
+            return 1;
+        }
+    }
+
+    std::ofstream archiveFile;
+    std::unique_ptr<GameArchiveWriter> archive;
+    if(!options.archive.empty()) {
+        archiveFile.open(options.archive, std::ios::binary);
+        if(!archiveFile) {
+            std::cerr << "Error: Couldn't open " << options.archive << "\n";
+            return 1;
+        }
+        archive.reset(new GameArchiveWriter(archiveFile));
+    }
+
+    ThreadPool pool(options.noThreads);
+    Match match(options, openings, pool, pgn.is_open() ? &pgn : nullptr, archive.get());
+    match.run();
+    pool.wait();
+    match.printReport(std::cout);
+    if(options.stats) {
+        Engine::stats().print(std::cerr);
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+# Concurrent engine-vs-engine matches with PGN output, Elo and SPRT report.
+
+TEMPLATE = app
+TARGET = selfplay
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    ../common/fen.cpp
+
+HEADERS += \
+    ../common/fen.hpp
@@ -0,0 +1,104 @@
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "server.hpp"
+#include "session.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace chess;
+
+namespace {
+
+struct Options {
+    std::string host = "127.0.0.1";
+    unsigned short port = 7878;
+    std::string unixPath;
+    size_t noThreads = 0;
+    size_t maxSessions = 100000;
+};
+
+server::Server* runningServer = nullptr;
+
+void handleSignal(int) {
+    if(runningServer) {
+        runningServer->stop();
+    }
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --host ADDR          TCP address to listen on (default 127.0.0.1)\n"
+              << "  --port N             TCP port to listen on (default 7878)\n"
+              << "  --unix PATH          listen on a Unix domain socket instead of TCP\n"
+              << "  --threads N          worker threads (default: all cores)\n"
+              << "  --max-sessions N     refuse new games above N sessions (default 100000)\n"
+              << "\n"
+              << "Line protocol, one command per line, one reply per command:\n"
+              << "  new [FEN]            start a game, replies ok ID\n"
+              << "  move ID e2e4         play a move, replies ok STATE\n"
+              << "  undo ID, redo ID     step through the game, replies ok PLY\n"
+              << "  moves ID             replies ok with every legal move\n"
+              << "  state ID             replies ok STATE TURN [check SQUARE]\n"
+              << "  close ID             end a game\n"
+              << "  metrics              replies ok with a JSON object\n"
+              << "  quit                 close the connection\n"
+              << "Failures reply error MESSAGE.\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--host" && hasValue) {
+            options.host = argv[++i];
+        } else if(arg == "--port" && hasValue) {
+            options.port = static_cast<unsigned short>(std::atoi(argv[++i]));
+        } else if(arg == "--unix" && hasValue) {
+            options.unixPath = argv[++i];
+        } else if(arg == "--threads" && hasValue) {
+            options.noThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if(arg == "--max-sessions" && hasValue) {
+            options.maxSessions = static_cast<size_t>(std::atoi(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    try {
+        server::SessionTable sessions(options.maxSessions);
+        ThreadPool pool(options.noThreads);
+        server::Server server(sessions, pool);
+        if(options.unixPath.empty()) {
+            server.listenTcp(options.host, options.port);
+            std::cerr << "Listening on " << options.host << ":" << options.port;
+        } else {
+            server.listenUnix(options.unixPath);
+            std::cerr << "Listening on " << options.unixPath;
+        }
+        std::cerr << " with " << pool.size() << " worker threads\n";
+
+        runningServer = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        server.run();
+        runningServer = nullptr;
+        std::cerr << server.getMetrics() << "\n";
+    } catch(std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
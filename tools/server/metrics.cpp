@@ -0,0 +1,72 @@
+#include "metrics.hpp"
+#include <fstream>
+#include <unistd.h>
+
+using namespace server;
+
+LatencyHistogram::LatencyHistogram()
+    : _count(0) {
+    for(auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    uint64_t nanoseconds = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    _buckets[getBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyHistogram::getPercentile(double percentile) const {
+    uint64_t count = getCount();
+    if(count == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+    if(rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for(size_t i = 0; i < NoBuckets; i++) {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if(seen >= rank) {
+            return std::chrono::nanoseconds(getUpperBound(i));
+        }
+    }
+    return std::chrono::nanoseconds(getUpperBound(NoBuckets - 1));
+}
+
+size_t LatencyHistogram::getBucket(uint64_t nanoseconds) {
+    if(nanoseconds < SubBuckets) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    size_t msb = 0;
+    while(nanoseconds >> (msb + 1)) {
+        msb++;
+    }
+    size_t sub = static_cast<size_t>(nanoseconds >> (msb - 3)) & (SubBuckets - 1);
+    return (msb - 2) * SubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::getUpperBound(size_t bucket) {
+    if(bucket < SubBuckets) {
+        return bucket;
+    }
+    size_t shift = bucket / SubBuckets - 1;
+    uint64_t lower = static_cast<uint64_t>(SubBuckets + bucket % SubBuckets) << shift;
+    return lower + (static_cast<uint64_t>(1) << shift) - 1;
+}
+
+size_t server::getResidentMemory() {
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0;
+    size_t resident = 0;
+    if(statm >> size >> resident) {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace server {
+
+// Lock free latency histogram with eight sub-buckets per power of two, so
+// percentiles are reported with at most 12.5% error.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram& other) = delete;
+
+    LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+    void record(std::chrono::nanoseconds latency);
+    uint64_t getCount() const;
+    std::chrono::nanoseconds getPercentile(double percentile) const;
+
+protected:
+    static size_t getBucket(uint64_t nanoseconds);
+    static uint64_t getUpperBound(size_t bucket);
+
+private:
+    static const size_t SubBuckets = 8;
+    static const size_t NoBuckets = 64 * SubBuckets;
+
+    std::atomic<uint64_t> _buckets[NoBuckets];
+    std::atomic<uint64_t> _count;
+};
+
+size_t getResidentMemory();
+
+}
@@ -0,0 +1,351 @@
+#include "server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace chess;
+using namespace server;
+
+namespace {
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error("Error: " + what + ": " + std::strerror(errno));
+}
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw systemError("fcntl");
+    }
+}
+
+std::string errorResponse(const std::string& what) {
+    const std::string prefix = "Error: ";
+    if(what.compare(0, prefix.size(), prefix) == 0) {
+        return "error " + what.substr(prefix.size());
+    }
+    return "error " + what;
+}
+
+}
+
+Server::Connection::Connection(int fd)
+    : fd(fd), input(), eof(false), failed(false), mutex(), requests(), output(),
+      busy(false), closing(false) {}
+
+Server::Server(SessionTable& sessions, ThreadPool& pool)
+    : _sessions(sessions), _pool(pool), _listener(-1), _wakePipe{-1, -1}, _unixPath(),
+      _connections(), _stopping(false), _noConnections(0), _noCommands(0),
+      _baseMemory(getResidentMemory()), _start(std::chrono::steady_clock::now()) {
+    if(pipe(_wakePipe) < 0) {
+        throw systemError("pipe");
+    }
+    setNonBlocking(_wakePipe[0]);
+    setNonBlocking(_wakePipe[1]);
+}
+
+Server::~Server() {
+    _pool.wait();
+    for(const auto& connection : _connections) {
+        ::close(connection->fd);
+    }
+    if(_listener >= 0) {
+        ::close(_listener);
+    }
+    if(!_unixPath.empty()) {
+        unlink(_unixPath.c_str());
+    }
+    ::close(_wakePipe[0]);
+    ::close(_wakePipe[1]);
+}
+
+void Server::listenTcp(const std::string& host, unsigned short port) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    int error = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if(error != 0) {
+        throw std::runtime_error("Error: Couldn't resolve " + host + ": " + gai_strerror(error));
+    }
+    for(addrinfo* address = addresses; address; address = address->ai_next) {
+        int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if(fd < 0) {
+            continue;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if(bind(fd, address->ai_addr, address->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0) {
+            _listener = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(addresses);
+    if(_listener < 0) {
+        throw systemError("Couldn't listen on " + host + ":" + std::to_string(port));
+    }
+    setNonBlocking(_listener);
+}
+
+void Server::listenUnix(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if(path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Error: Socket path is too long");
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    struct stat status;
+    if(stat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(path.c_str());
+    }
+    _listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(_listener < 0) {
+        throw systemError("socket");
+    }
+    if(bind(_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+            || ::listen(_listener, SOMAXCONN) < 0) {
+        throw systemError("Couldn't listen on " + path);
+    }
+    _unixPath = path;
+    setNonBlocking(_listener);
+}
+
+void Server::run() {
+    std::vector<pollfd> fds;
+    while(!_stopping.load()) {
+        fds.clear();
+        fds.push_back(pollfd{_listener, POLLIN, 0});
+        fds.push_back(pollfd{_wakePipe[0], POLLIN, 0});
+        for(const auto& connection : _connections) {
+            short events = 0;
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            if(!connection->eof && !connection->closing && connection->output.size() < MaxPendingOutput) {
+                events |= POLLIN;
+            }
+            if(!connection->output.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back(pollfd{events ? connection->fd : -1, events, 0});
+        }
+        if(poll(fds.data(), fds.size(), -1) < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw systemError("poll");
+        }
+        if(fds[1].revents & POLLIN) {
+            char buffer[256];
+            while(read(_wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        size_t noConnections = _connections.size();
+        for(size_t i = 0; i < noConnections; i++) {
+            short revents = fds[i + 2].revents;
+            if(revents & (POLLIN | POLLHUP | POLLERR)) {
+                readConnection(_connections[i]);
+            }
+            if(revents & POLLOUT) {
+                writeConnection(*_connections[i]);
+            }
+        }
+        if(fds[0].revents & POLLIN) {
+            acceptConnections();
+        }
+        for(auto it = _connections.begin(); it != _connections.end();) {
+            Connection& connection = **it;
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(connection.mutex);
+                bool drained = !connection.busy && connection.requests.empty() && connection.output.empty();
+                finished = (connection.failed && !connection.busy)
+                        || (drained && (connection.eof || connection.closing));
+            }
+            if(finished) {
+                ::close(connection.fd);
+                it = _connections.erase(it);
+                _noConnections--;
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void Server::stop() {
+    _stopping.store(true);
+    wake();
+}
+
+std::string Server::getMetrics() const {
+    const LatencyHistogram& latency = _sessions.getMoveLatency();
+    size_t noSessions = _sessions.size();
+    size_t memory = _sessions.getMemoryUsage();
+    size_t resident = getResidentMemory();
+    size_t residentDelta = resident > _baseMemory ? resident - _baseMemory : 0;
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    auto microseconds = [](std::chrono::nanoseconds ns) {
+        return ns.count() / 1000.0;
+    };
+    std::ostringstream json;
+    json << "{\"sessions\":" << noSessions
+         << ",\"connections\":" << _noConnections.load()
+         << ",\"commands\":" << _noCommands.load()
+         << ",\"session_bytes\":" << (noSessions ? memory / noSessions : 0)
+         << ",\"rss_bytes\":" << resident
+         << ",\"rss_per_session_bytes\":" << (noSessions ? residentDelta / noSessions : 0)
+         << ",\"moves\":" << latency.getCount()
+         << ",\"move_p50_us\":" << microseconds(latency.getPercentile(50.0))
+         << ",\"move_p99_us\":" << microseconds(latency.getPercentile(99.0))
+         << ",\"uptime_s\":" << uptime << "}";
+    return json.str();
+}
+
+void Server::acceptConnections() {
+    while(true) {
+        int fd = accept(_listener, nullptr, nullptr);
+        if(fd < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::perror("accept");
+            }
+            return;
+        }
+        setNonBlocking(fd);
+        _connections.push_back(std::make_shared<Connection>(fd));
+        _noConnections++;
+    }
+}
+
+void Server::readConnection(const std::shared_ptr<Connection>& connection) {
+    if(connection->eof) {
+        return;
+    }
+    char buffer[4096];
+    ssize_t received = read(connection->fd, buffer, sizeof(buffer));
+    if(received < 0) {
+        if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            connection->failed = true;
+        }
+        return;
+    }
+    std::string& input = connection->input;
+    if(received > 0) {
+        input.append(buffer, static_cast<size_t>(received));
+    } else if(!input.empty()) {
+        input += '\n';
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        connection->eof = received == 0;
+        size_t begin = 0;
+        size_t end;
+        while((end = input.find('\n', begin)) != std::string::npos) {
+            std::string line = input.substr(begin, end - begin);
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if(line.find_first_not_of(" \t") != std::string::npos) {
+                connection->requests.push_back(std::move(line));
+            }
+            begin = end + 1;
+        }
+        input.erase(0, begin);
+        if(input.size() > MaxLineLength) {
+            input.clear();
+            connection->output += "error Line too long\n";
+            connection->closing = true;
+        }
+        if(!connection->busy && !connection->requests.empty()) {
+            connection->busy = true;
+            schedule = true;
+        }
+    }
+    if(schedule) {
+        _pool.submit([this, connection]() {
+            process(connection);
+        });
+    }
+}
+
+void Server::writeConnection(Connection& connection) {
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    while(!connection.output.empty()) {
+        ssize_t sent = write(connection.fd, connection.output.data(), connection.output.size());
+        if(sent < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                connection.failed = true;
+                connection.output.clear();
+            }
+            return;
+        }
+        connection.output.erase(0, static_cast<size_t>(sent));
+    }
+}
+
+void Server::process(std::shared_ptr<Connection> connection) {
+    while(true) {
+        std::string line;
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            if(connection->requests.empty() || connection->failed) {
+                connection->requests.clear();
+                connection->busy = false;
+                break;
+            }
+            line = std::move(connection->requests.front());
+            connection->requests.pop_front();
+        }
+        std::string response = execute(*connection, line);
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            notify = connection->output.empty();
+            connection->output += response;
+            connection->output += '\n';
+        }
+        if(notify) {
+            wake();
+        }
+    }
+    wake();
+}
+
+std::string Server::execute(Connection& connection, const std::string& line) {
+    _noCommands++;
+    std::istringstream args(line);
+    std::string command;
+    args >> command;
+    try {
+        if(command == "metrics") {
+            return "ok " + getMetrics();
+        } else if(command == "quit") {
+            std::lock_guard<std::mutex> lock(connection.mutex);
+            connection.requests.clear();
+            connection.closing = true;
+            return "ok bye";
+        }
+        std::string result = _sessions.execute(command, args);
+        return result.empty() ? "ok" : "ok " + result;
+    } catch(std::exception& e) {
+        return errorResponse(e.what());
+    }
+}
+
+void Server::wake() {
+    char byte = 0;
+    ssize_t written = write(_wakePipe[1], &byte, 1);
+    (void)written;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../../include/chess/engine/thread_pool.hpp"
+#include "session.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace server {
+
+// Single threaded poll() event loop that owns every socket. Complete request
+// lines are handed to the worker pool one connection at a time, so replies
+// keep the order of the requests while different clients run in parallel.
+class Server {
+public:
+    static const size_t MaxLineLength = 64 * 1024;
+    static const size_t MaxPendingOutput = 1024 * 1024;
+
+    Server(SessionTable& sessions, chess::ThreadPool& pool);
+    Server(const Server& other) = delete;
+    ~Server();
+
+    Server& operator=(const Server& other) = delete;
+
+    void listenTcp(const std::string& host, unsigned short port);
+    void listenUnix(const std::string& path);
+    void run();
+    void stop();
+
+    std::string getMetrics() const;
+
+protected:
+    struct Connection {
+        explicit Connection(int fd);
+
+        int fd;
+        std::string input;
+        bool eof;
+        bool failed;
+        std::mutex mutex;
+        std::deque<std::string> requests;
+        std::string output;
+        bool busy;
+        bool closing;
+    };
+
+    void acceptConnections();
+    void readConnection(const std::shared_ptr<Connection>& connection);
+    void writeConnection(Connection& connection);
+    void process(std::shared_ptr<Connection> connection);
+    std::string execute(Connection& connection, const std::string& line);
+    void wake();
+
+private:
+    SessionTable& _sessions;
+    chess::ThreadPool& _pool;
+    int _listener;
+    int _wakePipe[2];
+    std::string _unixPath;
+    std::vector<std::shared_ptr<Connection>> _connections;
+    std::atomic<bool> _stopping;
+    std::atomic<size_t> _noConnections;
+    std::atomic<uint64_t> _noCommands;
+    size_t _baseMemory;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}
@@ -0,0 +1,24 @@
+# Multi-session game server speaking a line protocol over TCP or a Unix socket.
+
+TEMPLATE = app
+TARGET = server
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    metrics.cpp \
+    server.cpp \
+    session.cpp \
+    ../common/fen.cpp \
+    ../common/game_state.cpp
+
+HEADERS += \
+    metrics.hpp \
+    server.hpp \
+    session.hpp \
+    ../common/fen.hpp \
+    ../common/game_state.hpp
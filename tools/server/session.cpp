@@ -0,0 +1,174 @@
+#include "session.hpp"
+#include "../common/fen.hpp"
+#include "../common/game_state.hpp"
+#include <sstream>
+#include <stdexcept>
+
+using namespace chess;
+using namespace server;
+
+SessionTable::SessionTable(size_t maxSessions)
+    : _mutex(), _sessions(), _nextId(1), _maxSessions(maxSessions), _moveLatency() {}
+
+std::string SessionTable::execute(const std::string& command, std::istream& args) {
+    if(command == "new") {
+        return newGame(args);
+    } else if(command == "move") {
+        return move(args);
+    } else if(command == "undo") {
+        return undo(args);
+    } else if(command == "redo") {
+        return redo(args);
+    } else if(command == "moves") {
+        return legalMoves(args);
+    } else if(command == "state") {
+        return state(args);
+    } else if(command == "close") {
+        return close(args);
+    }
+    throw std::invalid_argument("Error: Unknown command " + command);
+}
+
+size_t SessionTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _sessions.size();
+}
+
+size_t SessionTable::getMemoryUsage() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    size_t usage = _sessions.bucket_count() * sizeof(void*);
+    for(const auto& entry : _sessions) {
+        std::lock_guard<std::mutex> sessionLock(entry.second->mutex);
+        usage += sizeof(std::pair<const uint64_t, std::shared_ptr<Session>>) + 2 * sizeof(void*);
+        usage += sizeof(Session) - sizeof(Engine) + entry.second->engine.getMemoryUsage();
+    }
+    return usage;
+}
+
+const LatencyHistogram& SessionTable::getMoveLatency() const {
+    return _moveLatency;
+}
+
+std::string SessionTable::newGame(std::istream& args) {
+    std::string fen;
+    std::getline(args, fen);
+    auto session = std::make_shared<Session>();
+    if(!tools::isBlank(fen)) {
+        fen = tools::extractFen(fen);
+        Game game(fen);
+        if(!game.getWhiteKingSquare() || !game.getBlackKingSquare()) {
+            throw std::invalid_argument("Error: Position is missing a king");
+        }
+        session->engine.setBoard(fen);
+    }
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    if(_sessions.size() >= _maxSessions) {
+        throw std::invalid_argument("Error: Too many sessions");
+    }
+    uint64_t id = _nextId++;
+    _sessions.emplace(id, std::move(session));
+    return std::to_string(id);
+}
+
+std::string SessionTable::move(std::istream& args) {
+    auto session = find(args);
+    std::string notation;
+    if(!(args >> notation) || (notation.size() != 4 && notation.size() != 5)) {
+        throw std::invalid_argument("Error: Expected a move in coordinate notation");
+    }
+    if(notation.size() == 5 && notation[4] != 'q') {
+        throw std::invalid_argument("Error: Only queen promotions are supported");
+    }
+    auto origin = Square::convertPosition(notation.substr(0, 2));
+    auto destination = Square::convertPosition(notation.substr(2, 2));
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    Engine& engine = session->engine;
+    if(engine.getGameState() != GameState::Playing) {
+        throw std::invalid_argument("Error: Game is over");
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool legal = engine.selectPiece(origin) && engine.move(destination);
+    _moveLatency.record(std::chrono::steady_clock::now() - start);
+    if(!legal) {
+        engine.deselectPiece();
+        throw std::invalid_argument("Error: Illegal move " + notation);
+    }
+    return tools::stateName(engine.getGameState());
+}
+
+std::string SessionTable::undo(std::istream& args) {
+    auto session = find(args);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    size_t position = session->engine.previousPosition();
+    if(position == static_cast<size_t>(-1)) {
+        throw std::invalid_argument("Error: Nothing to undo");
+    }
+    return std::to_string(position);
+}
+
+std::string SessionTable::redo(std::istream& args) {
+    auto session = find(args);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    size_t position = session->engine.nextPosition();
+    if(position == static_cast<size_t>(-1)) {
+        throw std::invalid_argument("Error: Nothing to redo");
+    }
+    return std::to_string(position);
+}
+
+std::string SessionTable::legalMoves(std::istream& args) {
+    auto session = find(args);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    Engine& engine = session->engine;
+    std::string response;
+    if(engine.getGameState() != GameState::Playing) {
+        return response;
+    }
+    for(const auto& move : engine.getLegalMoves()) {
+        if(!response.empty()) {
+            response += ' ';
+        }
+        response += move.getCoordinateNotation();
+    }
+    return response;
+}
+
+std::string SessionTable::state(std::istream& args) {
+    auto session = find(args);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    Engine& engine = session->engine;
+    std::ostringstream response;
+    response << tools::stateName(engine.getGameState()) << ' '
+             << (engine.getTurn() == PieceColor::White ? "white" : "black");
+    auto check = engine.getCheckPosition();
+    if(Board::positionExists(check)) {
+        response << " check " << Square::convertPosition(check);
+    }
+    return response.str();
+}
+
+std::string SessionTable::close(std::istream& args) {
+    uint64_t id;
+    if(!(args >> id)) {
+        throw std::invalid_argument("Error: Missing session id");
+    }
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    if(_sessions.erase(id) == 0) {
+        throw std::invalid_argument("Error: Unknown session " + std::to_string(id));
+    }
+    return std::to_string(id);
+}
+
+std::shared_ptr<Session> SessionTable::find(std::istream& args) {
+    uint64_t id;
+    if(!(args >> id)) {
+        throw std::invalid_argument("Error: Missing session id");
+    }
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto session = _sessions.find(id);
+    if(session == _sessions.end()) {
+        throw std::invalid_argument("Error: Unknown session " + std::to_string(id));
+    }
+    return session->second;
+}
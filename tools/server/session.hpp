@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../../include/chess/engine/engine.hpp"
+#include "metrics.hpp"
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace server {
+
+struct Session {
+    std::mutex mutex;
+    chess::Engine engine;
+};
+
+// Owns every game hosted by the server. Commands for different sessions run
+// in parallel; commands for the same session are serialised by its mutex.
+class SessionTable {
+public:
+    explicit SessionTable(size_t maxSessions);
+    SessionTable(const SessionTable& other) = delete;
+
+    SessionTable& operator=(const SessionTable& other) = delete;
+
+    std::string execute(const std::string& command, std::istream& args);
+
+    size_t size() const;
+    size_t getMemoryUsage() const;
+    const LatencyHistogram& getMoveLatency() const;
+
+protected:
+    std::string newGame(std::istream& args);
+    std::string move(std::istream& args);
+    std::string undo(std::istream& args);
+    std::string redo(std::istream& args);
+    std::string legalMoves(std::istream& args);
+    std::string state(std::istream& args);
+    std::string close(std::istream& args);
+
+    std::shared_ptr<Session> find(std::istream& args);
+
+private:
+    mutable std::shared_mutex _mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<Session>> _sessions;
+    uint64_t _nextId;
+    size_t _maxSessions;
+    LatencyHistogram _moveLatency;
+};
+
+}
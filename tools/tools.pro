@@ -0,0 +1,14 @@
+# Command line tools built on top of the chess engine.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    analyse \
+    archive \
+    bench \
+    difftest \
+    explorer \
+    perft \
+    selfplay
+
+unix: SUBDIRS += server